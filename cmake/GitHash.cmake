@@ -0,0 +1,55 @@
+#####################################################################################
+# The MIT License (MIT)
+#
+# Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#####################################################################################
+
+# Run with cmake -P at build time, so the hash follows the commits made after
+# configuring. The header is only rewritten when the hash changes.
+#
+#   GIT_EXECUTABLE  git, or empty when it was not found
+#   SOURCE_DIR      a directory of the repository
+#   INPUT           the template of the header
+#   OUTPUT          the header to write
+
+set(MIGRAPHX_GIT_HASH "unknown")
+if(GIT_EXECUTABLE)
+    execute_process(COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE MIGRAPHX_GIT_OUTPUT
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE MIGRAPHX_GIT_RESULT
+        ERROR_QUIET)
+    if(MIGRAPHX_GIT_RESULT EQUAL 0)
+        set(MIGRAPHX_GIT_HASH ${MIGRAPHX_GIT_OUTPUT})
+        # Changes that are not committed don't change the hash, so the time of
+        # the build is added to tell such builds apart
+        execute_process(COMMAND ${GIT_EXECUTABLE} diff-index --quiet HEAD --
+            WORKING_DIRECTORY ${SOURCE_DIR}
+            RESULT_VARIABLE MIGRAPHX_GIT_DIRTY
+            ERROR_QUIET)
+        if(NOT MIGRAPHX_GIT_DIRTY EQUAL 0)
+            string(TIMESTAMP MIGRAPHX_BUILD_TIME "%Y%m%d%H%M%S" UTC)
+            set(MIGRAPHX_GIT_HASH "${MIGRAPHX_GIT_HASH}-dirty-${MIGRAPHX_BUILD_TIME}")
+        endif()
+    endif()
+endif()
+configure_file(${INPUT} ${OUTPUT})
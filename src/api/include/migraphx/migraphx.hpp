@@ -1064,7 +1064,8 @@ struct program : MIGRAPHX_HANDLE_BASE(program)
         return shapes(pout, own{});
     }
 
-    /// Run the program using the inputs passed in
+    /// Run the program using the inputs passed in. It can be called from
+    /// several threads at once.
     arguments eval(const program_parameters& pparams) const
     {
         migraphx_arguments_t pout;
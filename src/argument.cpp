@@ -28,9 +28,24 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+static const argument_allocator_scope::allocator*& current_allocator()
+{
+    static thread_local const argument_allocator_scope::allocator* a = nullptr;
+    return a;
+}
+
+argument_allocator_scope::argument_allocator_scope(allocator a)
+    : current(std::move(a)), previous(current_allocator())
+{
+    current_allocator() = &current;
+}
+
+argument_allocator_scope::~argument_allocator_scope() { current_allocator() = previous; }
+
 argument::argument(const shape& s) : m_shape(s)
 {
-    auto buffer = make_shared_array<char>(s.bytes());
+    const auto* a = current_allocator();
+    auto buffer   = a == nullptr ? make_shared_array<char>(s.bytes()) : (*a)(s.bytes());
     assign_buffer({[=]() mutable { return buffer.get(); }});
 }
 
@@ -57,7 +57,7 @@ std::string compute_command_name()
         name = name.substr(0, name.size() - 8);
     if(ends_with(name, "_cmd"))
         name = name.substr(0, name.size() - 4);
-    return name;
+    return replace_string(name, "_", "-");
 }
 
 template <class T>
@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "compile_bench.hpp"
+
+#include <migraphx/algorithm.hpp>
+#include <migraphx/pass_telemetry.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/time.hpp>
+#include <sys/resource.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Reset the peak resident set size of the process to the current one, which
+// Linux supports since 4.0. Otherwise the peak is the peak of the process.
+static void reset_peak_rss()
+{
+    std::ofstream os("/proc/self/clear_refs");
+    if(os)
+        os << "5";
+}
+
+static std::size_t peak_rss_kb()
+{
+    std::ifstream is("/proc/self/status");
+    std::string line;
+    while(std::getline(is, line))
+    {
+        if(not starts_with(line, "VmHWM:"))
+            continue;
+        std::size_t kb = 0;
+        std::istringstream ss(line.substr(6));
+        if(ss >> kb)
+            return kb;
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static std::size_t count_instructions(const program& p)
+{
+    auto mods = p.get_modules();
+    return transform_accumulate(
+        mods.begin(), mods.end(), std::size_t{0}, std::plus<>{}, [](const module* m) {
+            return m->size();
+        });
+}
+
+value compile_bench(const std::string& model, const program& p, const target& t, unsigned n)
+{
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    reset_peak_rss();
+    double best = std::numeric_limits<double>::max();
+    std::vector<pass_record> records;
+    std::size_t instructions_after = 0;
+    // A cached program would skip the passes being measured
+    compile_options options;
+    options.program_cache = false;
+    for(unsigned i = 0; i < std::max(n, 1u); i++)
+    {
+        auto cp = p;
+        pass_telemetry telemetry;
+        auto ms = time<milliseconds>([&] { cp.compile(t, options); });
+        if(ms >= best)
+            continue;
+        best               = ms;
+        records            = telemetry.records();
+        instructions_after = count_instructions(cp);
+    }
+    std::map<std::string, std::size_t> hits;
+    for(const auto& r : records)
+    {
+        for(const auto& h : r.matcher_hits)
+            hits[h.first] += h.second;
+    }
+    value matcher_hits = value::object{};
+    for(const auto& h : hits)
+        matcher_hits[h.first] = h.second;
+
+    value result                  = value::object{};
+    result["model"]               = model;
+    result["target"]              = t.name();
+    result["iterations"]          = std::max(n, 1u);
+    result["compile_ms"]          = best;
+    result["peak_rss_kb"]         = peak_rss_kb();
+    result["instructions_before"] = count_instructions(p);
+    result["instructions_after"]  = instructions_after;
+    result["matcher_hits"]        = matcher_hits;
+    result["passes"]              = pass_records_to_value(records);
+    return result;
+}
+
+// Passes run once for each module, so add up the time of each pass
+static std::map<std::string, double> pass_times(const value& result)
+{
+    std::map<std::string, double> times;
+    for(const auto& pass : result.at("passes"))
+        times[pass.at("pass").to<std::string>()] += pass.at("time_ms").to<double>();
+    return times;
+}
+
+std::vector<std::string> compare_compile_bench(const value& results,
+                                               const value& baseline,
+                                               double threshold,
+                                               double min_ms)
+{
+    std::vector<std::string> regressions;
+    auto check = [&](const std::string& what, double current, double base) {
+        if(current - base <= min_ms or current <= base * (1 + threshold))
+            return;
+        std::stringstream ss;
+        ss << what << ": " << base << "ms -> " << current << "ms";
+        regressions.push_back(ss.str());
+    };
+    for(const auto& r : results)
+    {
+        auto model  = r.at("model").to<std::string>();
+        auto target = r.at("target").to<std::string>();
+        auto it     = std::find_if(baseline.begin(), baseline.end(), [&](const value& b) {
+            return b.at("model").to<std::string>() == model and
+                   b.at("target").to<std::string>() == target;
+        });
+        if(it == baseline.end())
+            continue;
+        auto name = model + " on " + target;
+        check(name, r.at("compile_ms").to<double>(), it->at("compile_ms").to<double>());
+        auto base_times = pass_times(*it);
+        for(const auto& p : pass_times(r))
+        {
+            if(contains(base_times, p.first))
+                check(name + ", " + p.first, p.second, base_times[p.first]);
+        }
+    }
+    return regressions;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
@@ -0,0 +1,54 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_RTGLIB_DRIVER_COMPILE_BENCH_HPP
+#define MIGRAPHX_GUARD_RTGLIB_DRIVER_COMPILE_BENCH_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/value.hpp>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+namespace driver {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Compile a copy of p for the target n times, and report the fastest compile
+/// with the time and instructions of each pass and the peak resident memory.
+/// The program cache is not used. The kernel cache has to be disabled with
+/// MIGRAPHX_DISABLE_KERNEL_CACHE before the first compile of the process.
+value compile_bench(const std::string& model, const program& p, const target& t, unsigned n = 1);
+
+/// Compare the results of compile_bench against a baseline, and describe the
+/// compile times and pass times that are slower by more than the threshold
+/// fraction and by more than min_ms milliseconds
+std::vector<std::string> compare_compile_bench(const value& results,
+                                               const value& baseline,
+                                               double threshold = 0.1,
+                                               double min_ms    = 1.0);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace driver
+} // namespace migraphx
+
+#endif
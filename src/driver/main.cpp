@@ -27,6 +27,7 @@
 #include "command.hpp"
 #include "precision.hpp"
 #include "perf.hpp"
+#include "compile_bench.hpp"
 #include "models.hpp"
 #include "marker_roctx.hpp"
 
@@ -34,7 +35,10 @@
 #include <migraphx/onnx.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
+#include <migraphx/kernel_cache.hpp>
+#include <migraphx/profile.hpp>
 #include <migraphx/version.h>
 
 #include <migraphx/dead_code_elimination.hpp>
@@ -49,6 +53,7 @@
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/register_target.hpp>
 
+#include <cstdlib>
 #include <fstream>
 
 namespace migraphx {
@@ -158,6 +163,17 @@ struct loader
         return output_node_names;
     }
 
+    static program load_model(const std::string& model, unsigned batch)
+    {
+        if(model == "resnet50")
+            return resnet50(batch);
+        if(model == "inceptionv3")
+            return inceptionv3(batch);
+        if(model == "alexnet")
+            return alexnet(batch);
+        MIGRAPHX_THROW("Unknown model: " + model);
+    }
+
     program load()
     {
         program p;
@@ -203,14 +219,7 @@ struct loader
         }
         else
         {
-            if(model == "resnet50")
-                p = resnet50(batch);
-            else if(model == "inceptionv3")
-                p = inceptionv3(batch);
-            else if(model == "alexnet")
-                p = alexnet(batch);
-            else
-                MIGRAPHX_THROW("Unknown model: " + model);
+            p = load_model(model, batch);
         }
         if(trim > 0)
         {
@@ -374,6 +383,10 @@ struct compiler
             quantize_int8(p, t, {params(p)});
         }
         p.compile(t, co);
+        auto stats = get_kernel_cache_stats();
+        if(stats.hits + stats.misses > 0)
+            std::cout << "Kernel cache: " << stats.hits << " hits, " << stats.misses << " misses"
+                      << std::endl;
         l.save(p);
         return p;
     }
@@ -486,11 +499,25 @@ struct run_cmd : command<run_cmd>
 struct perf : command<perf>
 {
     compiler c;
-    unsigned n = 100;
+    unsigned n      = 100;
+    bool counters   = false;
+    bool cost_model = false;
+    std::string json_file;
+    std::string trace_file;
     void parse(argument_parser& ap)
     {
         c.parse(ap);
         ap(n, {"--iterations", "-n"}, ap.help("Number of iterations to run for perf report"));
+        ap(counters,
+           {"--counters"},
+           ap.help("Read hardware counters for each instruction with perf_event_open"),
+           ap.set_value(true));
+        ap(cost_model,
+           {"--cost-model"},
+           ap.help("Print the flops and bytes of each operator estimated from the shapes"),
+           ap.set_value(true));
+        ap(json_file, {"--json"}, ap.help("Write the profile of each instruction as json"));
+        ap(trace_file, {"--trace"}, ap.help("Write the profile as a Chrome trace"));
     }
 
     void run()
@@ -499,8 +526,26 @@ struct perf : command<perf>
         auto p = c.compile();
         std::cout << "Allocating params ... " << std::endl;
         auto m = c.params(p);
+        if(counters and not hardware_counters{}.enabled())
+            std::cout << "Hardware counters are not available" << std::endl;
         std::cout << "Running performance report ... " << std::endl;
-        p.perf_report(std::cout, n, m, c.l.batch);
+        auto profiles = p.profile(m, n, counters);
+        p.perf_report(std::cout, n, m, c.l.batch, profiles);
+        if(cost_model)
+        {
+            std::cout << std::endl << "Cost model:" << std::endl;
+            print_cost_model(std::cout, p.cost_model());
+        }
+        if(not json_file.empty())
+        {
+            std::ofstream os(json_file);
+            os << to_pretty_json_string(profile_to_value(profiles)) << std::endl;
+        }
+        if(not trace_file.empty())
+        {
+            std::ofstream os(trace_file);
+            os << to_json_string(profile_to_chrome_trace(profiles)) << std::endl;
+        }
     }
 };
 
@@ -521,6 +566,110 @@ struct roctx : command<roctx>
     }
 };
 
+struct compile_bench_cmd : command<compile_bench_cmd>
+{
+    std::vector<std::string> models;
+    std::vector<std::string> onnx_files;
+    std::vector<std::string> targets;
+    unsigned batch = 1;
+    unsigned n     = 1;
+    std::string json_file;
+    std::string baseline;
+    double threshold = 10;
+    double min_ms    = 1;
+    void parse(argument_parser& ap)
+    {
+        ap(models,
+           {"--model"},
+           ap.help("Model to compile, all of them when no model or onnx file is given"),
+           ap.type("resnet50|inceptionv3|alexnet"),
+           ap.append());
+        ap(onnx_files, {"--onnx"}, ap.help("Onnx file to compile"), ap.append());
+        ap(targets,
+           {"--target"},
+           ap.help("Target to compile for, ref and cpu by default"),
+           ap.append());
+        ap(batch, {"--batch"}, ap.help("Set batch size for the models"));
+        ap(n, {"--iterations", "-n"}, ap.help("Compile n times and report the fastest"));
+        ap(json_file, {"--json"}, ap.help("Write the results as json to a file"));
+        ap(baseline,
+           {"--baseline"},
+           ap.help("Compare the results with the json written by a previous run"));
+        ap(threshold,
+           {"--threshold"},
+           ap.help("Percent slower than the baseline that is reported as a regression"));
+        ap(min_ms,
+           {"--min-ms"},
+           ap.help("Milliseconds slower than the baseline that is reported as a regression"));
+    }
+
+    void run()
+    {
+        // Kernels found in the cache would skip the compilation being measured.
+        // The variable is read once, so it is set before anything is compiled.
+        setenv("MIGRAPHX_DISABLE_KERNEL_CACHE", "1", 1);
+        std::vector<std::pair<std::string, program>> programs;
+        if(models.empty() and onnx_files.empty())
+            models = {"resnet50", "inceptionv3", "alexnet"};
+        for(const auto& model : models)
+            programs.emplace_back(model, loader::load_model(model, batch));
+        for(const auto& file : onnx_files)
+        {
+            onnx_options options;
+            options.default_dim_value = batch;
+            programs.emplace_back(file, parse_onnx(file, options));
+        }
+        if(targets.empty())
+            targets = {"ref", "cpu"};
+
+        value results = value::array{};
+        for(const auto& target_name : targets)
+        {
+            target t;
+            try
+            {
+                t = make_target(target_name);
+            }
+            catch(const std::exception& e)
+            {
+                std::cout << "Skipping " << target_name << ": " << e.what() << std::endl;
+                continue;
+            }
+            for(const auto& p : programs)
+            {
+                auto r = compile_bench(p.first, p.second, t, n);
+                std::cout << p.first << " on " << target_name << ": "
+                          << r.at("compile_ms").to<double>() << "ms, "
+                          << r.at("peak_rss_kb").to<std::size_t>() << "KB peak RSS" << std::endl;
+                results.push_back(r);
+            }
+        }
+        if(json_file.empty())
+        {
+            std::cout << to_pretty_json_string(results) << std::endl;
+        }
+        else
+        {
+            std::ofstream os(json_file);
+            os << to_pretty_json_string(results) << std::endl;
+        }
+        if(baseline.empty())
+            return;
+        auto regressions = compare_compile_bench(
+            results, from_json_string(read_string(baseline)), threshold / 100.0, min_ms);
+        if(regressions.empty())
+        {
+            std::cout << "No regressions against " << baseline << std::endl;
+            return;
+        }
+        std::cout << color::fg_red << "Regressions against " << baseline << ":" << color::reset
+                  << std::endl;
+        for(const auto& r : regressions)
+            std::cout << "    " << r << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+};
+
 struct op : command<op>
 {
     bool show_ops = false;
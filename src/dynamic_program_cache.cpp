@@ -0,0 +1,282 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/dynamic_program_cache.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <list>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+program specialize_program(const program& p,
+                           const std::unordered_map<std::string, shape>& param_shapes)
+{
+    program result = p;
+    auto* mm       = result.get_main_module();
+    std::vector<instruction_ref> instructions;
+    for(auto ins : iterator_for(*mm))
+        instructions.push_back(ins);
+
+    // Instructions that do not depend on the replaced parameters are kept,
+    // the others are added again after them so their shapes are computed
+    // from static inputs only
+    std::unordered_map<instruction_ref, instruction_ref> map_ins;
+    std::unordered_set<instruction_ref> changed;
+    std::vector<instruction_ref> old_params;
+    for(auto ins : instructions)
+    {
+        if(ins->name() == "@param")
+        {
+            auto param = any_cast<builtin::param>(ins->get_operator());
+            auto it    = param_shapes.find(param.parameter);
+            if(it == param_shapes.end() or it->second == ins->get_shape())
+            {
+                map_ins[ins] = ins;
+                continue;
+            }
+            if(it->second.dynamic())
+                MIGRAPHX_THROW("SPECIALIZE_PROGRAM: shape of parameter " + param.parameter +
+                               " is dynamic");
+            // Rename the old parameter so the new one can take its name and order
+            instruction::replace(ins,
+                                 builtin::param{param.parameter + "@dynamic", param.order},
+                                 ins->get_shape(),
+                                 {});
+            auto new_param = mm->insert_parameter(ins, param.parameter, it->second);
+            instruction::replace(new_param, param, it->second, {});
+            map_ins[ins] = new_param;
+            changed.insert(ins);
+            old_params.push_back(ins);
+        }
+        else if(ins->name() != "@return" and
+                std::none_of(ins->inputs().begin(), ins->inputs().end(), [&](auto input) {
+                    return contains(changed, input);
+                }))
+        {
+            map_ins[ins] = ins;
+        }
+        else
+        {
+            changed.insert(ins);
+        }
+    }
+    if(old_params.empty())
+        return result;
+
+    auto last    = std::prev(mm->end());
+    auto outputs = mm->add_instructions(instructions, map_ins);
+    if(last->name() == "@return")
+        mm->remove_instruction(last);
+    mm->add_return(outputs);
+    dead_code_elimination{}.apply(*mm);
+    for(auto param : old_params)
+        mm->remove_instruction(param);
+    return result;
+}
+
+struct dynamic_program_cache::impl
+{
+    struct entry
+    {
+        std::string key;
+        std::string bucket_key;
+        std::shared_ptr<program> compiled;
+        // Shapes of the padded parameters
+        std::unordered_map<std::string, shape> padded_shapes;
+        // Shapes of the outputs for the unpadded inputs, empty when not padded
+        std::vector<shape> output_shapes;
+    };
+
+    program prog;
+    target t;
+    compile_options options;
+    dynamic_program_cache_options cache_options;
+    std::vector<std::pair<std::string, shape>> dynamic_params;
+    std::list<entry> lru;
+    std::unordered_map<std::string, std::list<entry>::iterator> entries;
+    // Compiled programs are shared by the input shapes padded to the same bucket
+    std::unordered_map<std::string, std::weak_ptr<program>> bucket_programs;
+    dynamic_program_cache_stats stats;
+
+    std::size_t pad_length(const shape::dynamic_dimension& dd, std::size_t len) const
+    {
+        const auto& buckets = cache_options.buckets;
+        if(dd.is_fixed())
+            return len;
+        auto it = std::lower_bound(buckets.begin(), buckets.end(), len);
+        if(it == buckets.end())
+            return len;
+        return std::max(len, std::min(*it, dd.max));
+    }
+
+    static std::string
+    make_key(const std::vector<std::pair<std::string, std::vector<std::size_t>>>& lens)
+    {
+        std::string key;
+        for(const auto& p : lens)
+            key += p.first + ":" + to_string_range(p.second, ",") + ";";
+        return key;
+    }
+
+    entry& get(const parameter_map& params)
+    {
+        std::vector<std::pair<std::string, std::vector<std::size_t>>> lens;
+        for(const auto& p : dynamic_params)
+        {
+            auto it = params.find(p.first);
+            if(it == params.end())
+                MIGRAPHX_THROW("DYNAMIC_PROGRAM_CACHE: missing parameter " + p.first);
+            lens.emplace_back(p.first, it->second.get_shape().lens());
+        }
+        auto key = make_key(lens);
+        auto it  = entries.find(key);
+        if(it != entries.end())
+        {
+            stats.hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            return lru.front();
+        }
+        stats.misses++;
+
+        entry e;
+        e.key = key;
+        std::unordered_map<std::string, shape> shapes;
+        for(std::size_t i = 0; i < lens.size(); i++)
+        {
+            const auto& s = dynamic_params[i].second;
+            shapes[lens[i].first] = shape{s.type(), lens[i].second};
+            auto padded           = lens[i].second;
+            if(padded.size() == s.ndim())
+            {
+                std::transform(s.dyn_dims().begin(),
+                               s.dyn_dims().end(),
+                               padded.begin(),
+                               padded.begin(),
+                               [&](const auto& dd, auto len) { return pad_length(dd, len); });
+            }
+            if(padded != lens[i].second)
+                e.padded_shapes[lens[i].first] = shape{s.type(), padded};
+            lens[i].second = padded;
+        }
+        e.bucket_key = make_key(lens);
+        e.compiled   = bucket_programs[e.bucket_key].lock();
+        if(e.compiled == nullptr)
+        {
+            auto bucket_shapes = shapes;
+            for(const auto& p : e.padded_shapes)
+                bucket_shapes[p.first] = p.second;
+            e.compiled = std::make_shared<program>(specialize_program(prog, bucket_shapes));
+            e.compiled->compile(t, options);
+            bucket_programs[e.bucket_key] = e.compiled;
+            stats.compiled++;
+        }
+        if(not e.padded_shapes.empty())
+            e.output_shapes = specialize_program(prog, shapes).get_output_shapes();
+
+        lru.push_front(std::move(e));
+        entries[key] = lru.begin();
+        if(lru.size() > cache_options.capacity)
+        {
+            auto bucket_key = lru.back().bucket_key;
+            entries.erase(lru.back().key);
+            lru.pop_back();
+            if(bucket_programs[bucket_key].expired())
+                bucket_programs.erase(bucket_key);
+        }
+        return lru.front();
+    }
+};
+
+dynamic_program_cache::dynamic_program_cache(program p,
+                                             target t,
+                                             compile_options options,
+                                             dynamic_program_cache_options cache_options)
+    : m_impl(std::make_unique<impl>())
+{
+    m_impl->prog          = std::move(p);
+    m_impl->t             = std::move(t);
+    m_impl->options       = std::move(options);
+    m_impl->cache_options = std::move(cache_options);
+    std::sort(m_impl->cache_options.buckets.begin(), m_impl->cache_options.buckets.end());
+    m_impl->cache_options.capacity = std::max<std::size_t>(1, m_impl->cache_options.capacity);
+    const auto* mm                 = m_impl->prog.get_main_module();
+    for(const auto& name : mm->get_parameter_names())
+    {
+        auto s = mm->get_parameter_shape(name);
+        if(s.dynamic())
+            m_impl->dynamic_params.emplace_back(name, s);
+    }
+}
+
+dynamic_program_cache::~dynamic_program_cache() = default;
+
+// Copy the argument into the start of a zero-filled buffer of the padded shape
+static argument pad_argument(const argument& a, const shape& padded)
+{
+    argument result{padded};
+    std::fill(result.data(), result.data() + padded.bytes(), 0);
+    const auto type_size = padded.type_size();
+    shape window{padded.type(), a.get_shape().lens(), padded.strides()};
+    shape_for_each_offset(window, a.get_shape())([&](auto i, auto j) {
+        std::copy_n(a.data() + j * type_size, type_size, result.data() + i * type_size);
+    });
+    return result;
+}
+
+std::vector<argument> dynamic_program_cache::eval(parameter_map params)
+{
+    auto& e = m_impl->get(params);
+    for(const auto& p : e.padded_shapes)
+        params[p.first] = pad_argument(params[p.first], p.second);
+    auto results = e.compiled->eval(std::move(params));
+    if(e.output_shapes.size() != results.size())
+        return results;
+    // Slice the outputs back to the shapes of the unpadded inputs
+    std::transform(results.begin(),
+                   results.end(),
+                   e.output_shapes.begin(),
+                   results.begin(),
+                   [](const argument& r, const shape& s) {
+                       const auto& rs = r.get_shape();
+                       if(s.dynamic() or rs.type() == shape::tuple_type or s == rs or
+                          s.ndim() != rs.ndim())
+                           return r;
+                       return r.reshape(shape{rs.type(), s.lens(), rs.strides()});
+                   });
+    return results;
+}
+
+std::size_t dynamic_program_cache::size() const { return m_impl->lru.size(); }
+
+dynamic_program_cache_stats dynamic_program_cache::stats() const { return m_impl->stats; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -25,6 +25,10 @@
 #include <migraphx/errors.hpp>
 #include <fstream>
 #include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -72,5 +76,27 @@ void write_buffer(const std::string& filename, const std::vector<char>& buffer)
     write_buffer(filename, buffer.data(), buffer.size());
 }
 
+mapped_file map_file(const std::string& filename)
+{
+    mapped_file result;
+    int fd = ::open(filename.c_str(), O_RDONLY); // NOLINT
+    if(fd < 0)
+        return result;
+    struct stat st = {};
+    if(::fstat(fd, &st) == 0 and st.st_size > 0)
+    {
+        std::size_t size = st.st_size;
+        void* addr       = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(addr != MAP_FAILED) // NOLINT
+        {
+            result.size = size;
+            result.data = std::shared_ptr<char>(static_cast<char*>(addr),
+                                                [size](char* x) { ::munmap(x, size); });
+        }
+    }
+    ::close(fd);
+    return result;
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/host_info.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/version.h>
+#include <migraphx/git_hash.h>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+static std::string read_host_isa()
+{
+    std::ifstream is("/proc/cpuinfo");
+    std::string vendor;
+    std::string model;
+    std::string features;
+    std::string line;
+    // Only the first processor is read, since the processors of a host are
+    // the same kind
+    while(std::getline(is, line) and not trim(line).empty())
+    {
+        auto colon = line.find(':');
+        if(colon == std::string::npos)
+            continue;
+        auto name  = trim(line.substr(0, colon));
+        auto value = trim(line.substr(colon + 1));
+        if(name == "vendor_id" or name == "CPU implementer")
+            vendor = value;
+        else if(name == "model name" or name == "CPU part")
+            model = value;
+        else if(name == "flags" or name == "Features")
+            features = value;
+    }
+    if(vendor.empty() and model.empty() and features.empty())
+        return "unknown";
+    // The feature list is long, so only its FNV-1a hash is used
+    std::uint64_t h = 14695981039346656037ull;
+    for(char c : features)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    std::stringstream ss;
+    ss << vendor << "," << model << "," << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+}
+
+std::string get_host_isa()
+{
+    static const std::string result = read_host_isa();
+    return result;
+}
+
+std::string get_build_compiler()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string get_build_version() { return std::string{MIGRAPHX_VERSION} + "-" + MIGRAPHX_GIT_HASH; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -107,6 +107,28 @@ struct argument : raw_data<argument>
     data_t m_data{};
 };
 
+/**
+ * @brief Allocates the buffers of `argument{s}` made on this thread while it is alive
+ *
+ * This lets a target serve the allocations an operator makes during compute from memory it
+ * manages. The allocator must return zero-initialized memory of at least the requested size.
+ */
+struct argument_allocator_scope
+{
+    using allocator = std::function<std::shared_ptr<char>(std::size_t)>;
+
+    explicit argument_allocator_scope(allocator a);
+
+    argument_allocator_scope(const argument_allocator_scope&) = delete;
+    argument_allocator_scope& operator=(const argument_allocator_scope&) = delete;
+
+    ~argument_allocator_scope();
+
+    private:
+    allocator current;
+    const allocator* previous = nullptr;
+};
+
 std::vector<shape> to_shapes(const std::vector<argument>& args);
 void migraphx_to_value(value& v, const argument& a);
 void migraphx_from_value(const value& v, argument& a);
@@ -35,6 +35,8 @@ struct compile_options
     bool offload_copy    = false;
     bool fast_math       = true;
     bool exhaustive_tune = false;
+    /// Reuse the compiled program from the cache set by MIGRAPHX_PROGRAM_CACHE_PATH
+    bool program_cache = true;
     tracer trace{};
 };
 
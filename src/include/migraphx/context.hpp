@@ -46,6 +46,11 @@ struct context
 {
     /// Wait for any tasks in the context to complete
     void finish() const;
+    /// An optional method to make a context to run the program concurrently
+    /// with this one. It shares what is constant after compilation, such as
+    /// the literals, and owns the rest, such as the streams. When it is not
+    /// implemented, it is a copy of the context.
+    context fork() const;
 };
 
 #else
@@ -77,6 +82,11 @@ void finish_on_context(T&, any_ptr)
 {
 }
 
+struct context;
+
+template <class T>
+context fork_context(const T& x);
+
 #ifdef TYPE_ERASED_DECLARATION
 
 // Type-erased interface for:
@@ -94,6 +104,8 @@ struct context
     void finish_on(any_ptr queue);
     //
     void finish() const;
+    // (optional)
+    context fork() const;
 };
 
 #else
@@ -197,6 +209,12 @@ struct context
         (*this).private_detail_te_get_handle().finish();
     }
 
+    context fork() const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().fork();
+    }
+
     friend bool is_shared(const context& private_detail_x, const context& private_detail_y)
     {
         return private_detail_x.private_detail_te_handle_mem_var ==
@@ -216,6 +234,7 @@ struct context
         virtual void wait_for(any_ptr queue)    = 0;
         virtual void finish_on(any_ptr queue)   = 0;
         virtual void finish() const             = 0;
+        virtual context fork() const            = 0;
     };
 
     template <class T>
@@ -286,6 +305,19 @@ struct context
         finish_on_context(private_detail_te_self, queue);
     }
 
+    template <class T>
+    static auto private_detail_te_default_fork(char, T&& private_detail_te_self)
+        -> decltype(private_detail_te_self.fork())
+    {
+        return private_detail_te_self.fork();
+    }
+
+    template <class T>
+    static context private_detail_te_default_fork(float, T&& private_detail_te_self)
+    {
+        return fork_context(private_detail_te_self);
+    }
+
     template <typename PrivateDetailTypeErasedT>
     struct private_detail_te_handle_type : private_detail_te_handle_base_type
     {
@@ -346,6 +378,12 @@ struct context
 
         void finish() const override { private_detail_te_value.finish(); }
 
+        context fork() const override
+        {
+
+            return private_detail_te_default_fork(char(0), private_detail_te_value);
+        }
+
         PrivateDetailTypeErasedT private_detail_te_value;
     };
 
@@ -412,6 +450,12 @@ inline const ValueType& any_cast(const context& x)
 }
 #endif
 
+template <class T>
+context fork_context(const T& x)
+{
+    return x;
+}
+
 inline void migraphx_to_value(value& v, const context& ctx) { v = ctx.to_value(); }
 
 inline void migraphx_from_value(const value& v, context& ctx) { ctx.from_value(v); }
@@ -0,0 +1,100 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_DYNAMIC_PROGRAM_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_DYNAMIC_PROGRAM_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/target.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Replace the dynamic parameters of the main module with the given static
+/// shapes, and recompute the shapes of the instructions that use them
+program specialize_program(const program& p,
+                           const std::unordered_map<std::string, shape>& param_shapes);
+
+struct dynamic_program_cache_options
+{
+    /// Number of input shapes kept, the least recently used is dropped first
+    std::size_t capacity = 64;
+    /// Sorted lengths the dynamic dimensions are padded up to, so that inputs
+    /// with lengths in between share a compiled program. The inputs are
+    /// padded with zeros on the host, and the outputs are sliced back to the
+    /// shapes of the unpadded inputs. This is only valid when the padding
+    /// does not change the other elements, such as when padding the batch.
+    std::vector<std::size_t> buckets = {};
+};
+
+struct dynamic_program_cache_stats
+{
+    std::size_t hits     = 0;
+    std::size_t misses   = 0;
+    std::size_t compiled = 0;
+};
+
+/**
+ * Evaluates a program with dynamic input shapes by compiling a static
+ * program for each input shape on first use. Later evaluations with the same
+ * shapes run the compiled program directly, without computing any shapes.
+ *
+ * The compiled programs can be evaluated from several threads at once, but
+ * the cache's own map of input shapes, its LRU order and its stats are not
+ * locked. So calls to eval, size and stats on one cache must not overlap.
+ * Threads that evaluate concurrently should each have a cache, or serialize
+ * their calls.
+ */
+struct dynamic_program_cache
+{
+    dynamic_program_cache(program p,
+                          target t,
+                          compile_options options                     = compile_options{},
+                          dynamic_program_cache_options cache_options = {});
+
+    dynamic_program_cache(const dynamic_program_cache&) = delete;
+    dynamic_program_cache& operator=(const dynamic_program_cache&) = delete;
+
+    ~dynamic_program_cache();
+
+    std::vector<argument> eval(parameter_map params);
+
+    /// Number of input shapes currently cached
+    std::size_t size() const;
+
+    dynamic_program_cache_stats stats() const;
+
+    private:
+    struct impl;
+    std::unique_ptr<impl> m_impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_DYNAMIC_PROGRAM_CACHE_HPP
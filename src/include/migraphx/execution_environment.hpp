@@ -33,6 +33,9 @@ struct execution_environment
 {
     any_ptr queue = any_ptr{};
     bool async    = false;
+    // Copy the outputs that are in the preallocated memory of the program, for
+    // callers that keep the outputs of several calls to eval
+    bool detach = false;
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -25,6 +25,7 @@
 #define MIGRAPHX_GUARD_RTGLIB_FILE_BUFFER_HPP
 
 #include <migraphx/config.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,17 @@ std::string read_string(const std::string& filename);
 void write_buffer(const std::string& filename, const char* buffer, std::size_t size);
 void write_buffer(const std::string& filename, const std::vector<char>& buffer);
 
+struct mapped_file
+{
+    std::shared_ptr<char> data = nullptr;
+    std::size_t size           = 0;
+};
+
+/// Maps the file privately into memory, so writes never reach the file. The
+/// mapping is released with the last copy of data. Returns an empty mapping
+/// when the file cannot be mapped.
+mapped_file map_file(const std::string& filename);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
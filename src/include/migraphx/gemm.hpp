@@ -26,35 +26,126 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/dfor.hpp>
+#include <migraphx/float_equal.hpp>
 #include <migraphx/par_for.hpp>
 #include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-template <class T, class F>
-void gemm(tensor_view<T> cmat, tensor_view<T> amat, tensor_view<T> bmat, F alpha, F beta)
+// Integers accumulate exactly, and floating point types accumulate in double
+template <class T>
+using gemm_accumulator =
+    std::conditional_t<std::is_integral<T>{},
+                       std::conditional_t<(sizeof(T) <= sizeof(int32_t)), int32_t, int64_t>,
+                       double>;
+
+// Sizes of the tiles computed by one task, chosen so the packed tiles fit in cache
+constexpr std::size_t gemm_block_m = 32;
+constexpr std::size_t gemm_block_n = 128;
+constexpr std::size_t gemm_block_k = 128;
+
+/// Computes cmat = alpha * amat * bmat + beta * cmat over the last two
+/// dimensions, where the leading dimensions are batches and can be broadcasted.
+/// The output is split into tiles that are computed in parallel, and each
+/// tile packs the blocks of A and B it reads so the inner loop is contiguous.
+template <class T, class U, class V, class F>
+void gemm(tensor_view<T> cmat, tensor_view<U> amat, tensor_view<V> bmat, F alpha, F beta)
 {
-    std::size_t n_dims = cmat.get_shape().lens().size();
+    using acc_type = gemm_accumulator<T>;
+
+    const auto& cs     = cmat.get_shape();
+    const auto& as     = amat.get_shape();
+    const auto& bs     = bmat.get_shape();
+    std::size_t n_dims = cs.lens().size();
     std::size_t dim_0  = n_dims - 2;
     std::size_t dim_1  = n_dims - 1;
-    auto k             = amat.get_shape().lens()[dim_1];
+    auto m             = cs.lens()[dim_0];
+    auto n             = cs.lens()[dim_1];
+    auto k             = as.lens()[dim_1];
+
+    assert(as.lens()[dim_1] == bs.lens()[dim_0]);
+    assert(cs.lens()[dim_0] == as.lens()[dim_0]);
+    assert(cs.lens()[dim_1] == bs.lens()[dim_1]);
+
+    std::size_t nbatch = std::accumulate(
+        cs.lens().begin(), cs.lens().begin() + dim_0, std::size_t{1}, std::multiplies<>{});
+    // Offsets of the batch in each matrix, following the strides so
+    // broadcasted batches are read from the same place
+    auto batch_offsets = [&](std::size_t batch) {
+        std::array<std::size_t, 3> offsets = {0, 0, 0};
+        for(std::size_t d = dim_0; d > 0; d--)
+        {
+            auto len = cs.lens()[d - 1];
+            auto idx = batch % len;
+            batch /= len;
+            offsets[0] += idx * cs.strides()[d - 1];
+            offsets[1] += idx * as.strides()[d - 1];
+            offsets[2] += idx * bs.strides()[d - 1];
+        }
+        return offsets;
+    };
+
+    std::size_t mblocks = (m + gemm_block_m - 1) / gemm_block_m;
+    std::size_t nblocks = (n + gemm_block_n - 1) / gemm_block_n;
+    par_for(nbatch * mblocks * nblocks, 1, [&](auto tile) {
+        auto j0      = (tile % nblocks) * gemm_block_n;
+        auto i0      = (tile / nblocks % mblocks) * gemm_block_m;
+        auto offsets = batch_offsets(tile / nblocks / mblocks);
+        auto mc      = std::min(gemm_block_m, m - i0);
+        auto nc      = std::min(gemm_block_n, n - j0);
+
+        T* c       = cmat.data() + offsets[0];
+        const U* a = amat.data() + offsets[1];
+        const V* b = bmat.data() + offsets[2];
 
-    assert(amat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_0] == amat.get_shape().lens()[dim_0]);
-    assert(cmat.get_shape().lens()[dim_1] == bmat.get_shape().lens()[dim_1]);
-    auto cs = cmat.get_shape();
+        std::vector<acc_type> apack(mc * gemm_block_k);
+        std::vector<acc_type> bpack(gemm_block_k * nc);
+        std::vector<acc_type> acc(mc * nc, 0);
+        for(std::size_t k0 = 0; k0 < k; k0 += gemm_block_k)
+        {
+            auto kc = std::min(gemm_block_k, k - k0);
+            for(std::size_t i = 0; i < mc; i++)
+                for(std::size_t kk = 0; kk < kc; kk++)
+                    apack[i * kc + kk] = static_cast<acc_type>(
+                        a[(i0 + i) * as.strides()[dim_0] + (k0 + kk) * as.strides()[dim_1]]);
+            for(std::size_t kk = 0; kk < kc; kk++)
+                for(std::size_t j = 0; j < nc; j++)
+                    bpack[kk * nc + j] = static_cast<acc_type>(
+                        b[(k0 + kk) * bs.strides()[dim_0] + (j0 + j) * bs.strides()[dim_1]]);
+            for(std::size_t i = 0; i < mc; i++)
+            {
+                acc_type* crow = acc.data() + i * nc;
+                for(std::size_t kk = 0; kk < kc; kk++)
+                {
+                    const acc_type x     = apack[i * kc + kk];
+                    const acc_type* brow = bpack.data() + kk * nc;
+                    for(std::size_t j = 0; j < nc; j++)
+                        crow[j] += x * brow[j];
+                }
+            }
+        }
 
-    par_for(cs.elements(), [&](auto i) {
-        auto c_idx = cs.multi(i);
-        auto a_idx = c_idx;
-        auto b_idx = c_idx;
-        double s   = 0.0;
-        dfor(k)([&](auto kk) {
-            a_idx[dim_1] = b_idx[dim_0] = kk;
-            s += amat(a_idx.begin(), a_idx.end()) * bmat(b_idx.begin(), b_idx.end());
-        });
-        cmat(c_idx.begin(), c_idx.end()) = alpha * s + cmat(c_idx.begin(), c_idx.end()) * beta;
+        for(std::size_t i = 0; i < mc; i++)
+        {
+            for(std::size_t j = 0; j < nc; j++)
+            {
+                auto idx = (i0 + i) * cs.strides()[dim_0] + (j0 + j) * cs.strides()[dim_1];
+                // Dont read the output when beta is zero since it may not be initialized
+                if(float_equal(beta, F{0}))
+                    c[idx] = static_cast<T>(alpha * acc[i * nc + j]);
+                else
+                    c[idx] = static_cast<T>(alpha * acc[i * nc + j] +
+                                               beta * static_cast<acc_type>(c[idx]));
+            }
+        }
     });
 }
 
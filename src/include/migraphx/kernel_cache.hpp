@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_KERNEL_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_KERNEL_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/filesystem.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct kernel_cache_stats
+{
+    std::size_t hits   = 0;
+    std::size_t misses = 0;
+};
+
+/**
+ * Directory store of compiled kernels. Entries are keyed by a string that
+ * should contain everything that affects the compiled output (the source,
+ * the compiler, its flags and the target), and are stored under the hash
+ * of the key.
+ */
+struct kernel_cache
+{
+    fs::path path;
+    /// Bytes the entries can take up before the least recently used ones
+    /// are removed, or zero for no limit
+    std::size_t max_size = 0;
+
+    bool enabled() const { return not path.empty(); }
+
+    /// Maps the entry for the key, whose data starts after the key and its
+    /// null terminator. Returns an empty mapping when there is no entry.
+    mapped_file map(const std::string& key) const;
+
+    // Returns an empty buffer when there is no entry for the key
+    std::vector<char> get(const std::string& key) const;
+
+    void put(const std::string& key, const std::vector<char>& data) const;
+
+    std::vector<char> get_or_compile(const std::string& key,
+                                     const std::function<std::vector<char>()>& compile) const;
+};
+
+/// The cache set by MIGRAPHX_KERNEL_CACHE_PATH, or the user cache directory
+/// by default. It is disabled when MIGRAPHX_DISABLE_KERNEL_CACHE is set.
+/// MIGRAPHX_KERNEL_CACHE_MAX_SIZE sets its size in megabytes, which is 1024
+/// by default, or 0 for no limit.
+kernel_cache get_kernel_cache();
+
+/// Hits and misses of all the kernel caches in this process
+kernel_cache_stats get_kernel_cache_stats();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_KERNEL_CACHE_HPP
@@ -32,6 +32,7 @@
 #include <migraphx/make_shared_array.hpp>
 #include <migraphx/config.hpp>
 
+#include <functional>
 #include <memory>
 
 namespace migraphx {
@@ -87,6 +88,9 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Uses the buffer directly, sharing ownership of it instead of copying
+    literal(const shape& s, std::shared_ptr<char> x) : buffer(std::move(x)), m_shape(s) {}
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -97,12 +101,9 @@ struct literal : raw_data<literal>
 
     std::vector<literal> get_sub_objects() const { return {}; }
 
-    /// Convert the data to an argument
-    argument get_argument() const
-    {
-        auto b = make_shared_array<char>(buffer.get(), buffer.get() + m_shape.bytes());
-        return {m_shape, [b]() { return b.get(); }};
-    }
+    /// An argument that refers to the data of the literal without copying it,
+    /// and keeps the data alive
+    argument get_argument() const { return {m_shape, buffer}; }
 
     private:
     std::shared_ptr<char> buffer;
@@ -150,6 +151,32 @@ literal transform(literal l1, literal l2, F f)
 void migraphx_to_value(value& v, const literal& l);
 void migraphx_from_value(const value& v, literal& l);
 
+/**
+ * @brief Serializes the data of literals and arguments converted to or from a value on this thread
+ * while it is alive
+ *
+ * The data goes through the callbacks instead of being copied into the value, which lets a file
+ * format store the data held by operators out of line, the same way as the literals of a program.
+ */
+struct raw_data_serializer_scope
+{
+    using save_function = std::function<value(const literal&)>;
+    using load_function = std::function<literal(const value&)>;
+
+    raw_data_serializer_scope(save_function s, load_function l);
+
+    raw_data_serializer_scope(const raw_data_serializer_scope&) = delete;
+    raw_data_serializer_scope& operator=(const raw_data_serializer_scope&) = delete;
+
+    ~raw_data_serializer_scope();
+
+    save_function save;
+    load_function load;
+
+    private:
+    const raw_data_serializer_scope* previous = nullptr;
+};
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
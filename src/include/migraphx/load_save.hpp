@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_LOAD_SAVE_HPP
 #define MIGRAPHX_GUARD_RTGLIB_LOAD_SAVE_HPP
 
+#include <migraphx/file_buffer.hpp>
 #include <migraphx/program.hpp>
 #include <string>
 #include <vector>
@@ -37,6 +38,11 @@ struct file_options
 };
 
 program load(const std::string& filename, const file_options& options = file_options{});
+/// Loads the program stored at the offset in the mapping. The literals of the
+/// binary format use the mapping in place, and keep it alive.
+program load_mapping(const mapped_file& file,
+                     std::size_t offset          = 0,
+                     const file_options& options = file_options{});
 program load_buffer(const std::vector<char>& buffer, const file_options& options = file_options{});
 program
 load_buffer(const char* buffer, std::size_t size, const file_options& options = file_options{});
@@ -29,9 +29,13 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/module.hpp>
 #include <migraphx/optional.hpp>
+#include <migraphx/pass_telemetry.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/type_name.hpp>
 #include <migraphx/config.hpp>
+#include <algorithm>
+#include <deque>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -89,6 +93,44 @@ struct matcher_context
     module* mod = nullptr;
 };
 
+template <class M>
+auto get_root_names(rank<1>, const M& m) -> decltype(m.root_names())
+{
+    return m.root_names();
+}
+
+template <class M>
+std::unordered_set<std::string> get_root_names(rank<0>, const M&)
+{
+    return {};
+}
+
+/// The operator names the instruction passed to a matcher must have for it to
+/// match, which is empty when it can be any operator
+template <class M>
+std::unordered_set<std::string> root_names(const M& m)
+{
+    return get_root_names(rank<1>{}, m);
+}
+
+/// A matcher that only matches instructions with one of the names
+template <class M>
+struct root_name_matcher
+{
+    M m;
+    std::unordered_set<std::string> names;
+
+    const std::unordered_set<std::string>& root_names() const { return names; }
+
+    auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
+};
+
+template <class M>
+root_name_matcher<M> make_root_name_matcher(M m, std::unordered_set<std::string> names)
+{
+    return {m, std::move(names)};
+}
+
 /// Convert a predicate function into a matcher
 template <class P>
 struct predicate_matcher
@@ -143,7 +185,12 @@ struct bindable_matcher
 {
     M m;
 
-    auto bind(std::string name) const { return bind_match(m, std::move(name)); }
+    auto bind(std::string name) const
+    {
+        return make_root_name_matcher(bind_match(m, std::move(name)), match::root_names(m));
+    }
+
+    auto root_names() const { return match::root_names(m); }
 
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
 };
@@ -203,8 +250,7 @@ struct basic_matcher
     {
         // Copy m because we cant capture `this` by value
         auto mm = m;
-        return make_basic_fun_matcher([=](matcher_context& ctx,
-                                          instruction_ref ins) -> optional<instruction_ref> {
+        auto f  = [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
             auto result = mm.match(ctx, ins);
             if(result)
             {
@@ -214,10 +260,17 @@ struct basic_matcher
                     return result;
             }
             return nullopt;
-        });
+        };
+        return make_basic_matcher(
+            make_root_name_matcher(make_function_matcher(f), match::root_names(m)));
+    }
+
+    auto bind(std::string name) const
+    {
+        return make_root_name_matcher(bind_match(m, std::move(name)), match::root_names(m));
     }
 
-    auto bind(std::string name) const { return bind_match(m, std::move(name)); }
+    auto root_names() const { return match::root_names(m); }
 
     auto match(matcher_context& ctx, instruction_ref ins) const { return m.match(ctx, ins); }
 };
@@ -249,9 +302,16 @@ using any_matcher_base = basic_matcher<
 struct any_matcher : any_matcher_base
 {
     template <class M>
-    any_matcher(M mm) : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }})
+    any_matcher(M mm)
+        : any_matcher_base({[=](auto& ctx, auto ins) { return mm.match(ctx, ins); }}),
+          names(match::root_names(mm))
     {
     }
+
+    const std::unordered_set<std::string>& root_names() const { return names; }
+
+    private:
+    std::unordered_set<std::string> names;
 };
 
 /// This macro takes care of the boilerplate for defining a matcher
@@ -348,18 +408,36 @@ match::matcher_result find_match(module& modl, M&& m)
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_MATCHES)
 
-/// Find matches for an instruction in the module
-template <class Mod, class... Ms>
-void find_matches(Mod& mod, instruction_ref ins, Ms&&... ms)
+namespace detail {
+
+template <class... Ms>
+std::vector<std::unordered_set<std::string>> matcher_root_names(const Ms&... ms)
+{
+    return {root_names(ms.matcher())...};
+}
+
+// Apply the first matcher that matches ins, skipping the matchers whose root
+// names rule it out. f is called with the match before it is applied. Returns
+// the index of the matcher applied, or -1 when none matched.
+template <class Mod, class F, class... Ms>
+int match_first(Mod& mod,
+                instruction_ref ins,
+                const std::vector<std::unordered_set<std::string>>& names,
+                F f,
+                Ms&&... ms)
 {
 #if !defined(__GNUC__) || defined(__clang__) || __GNUC__ > 5
     const
 #endif
         int trace = value_of(MIGRAPHX_TRACE_MATCHES{});
-    bool match    = false;
+    int matched   = -1;
+    int i         = 0;
     each_args(
         [&](auto&& m) {
-            if(match)
+            auto index = i++;
+            if(matched >= 0)
+                return;
+            if(not names[index].empty() and names[index].count(ins->name()) == 0)
                 return;
             if(trace > 1)
                 std::cout << "Match: " << get_type_name(m) << std::endl;
@@ -371,20 +449,225 @@ void find_matches(Mod& mod, instruction_ref ins, Ms&&... ms)
                 std::cout << "Matched by " << get_type_name(m) << std::endl;
                 get_module(mod).debug_print(ins);
             }
+            f(r);
             m.apply(mod, r);
-            match = true;
+            matched = index;
         },
         ms...);
+    return matched;
+}
+
+// Remove ins when it is unused, along with any of its inputs left unused, in
+// the same way as dead_code_elimination. f is called with the instructions
+// that lost an output and remain.
+template <class F>
+void remove_unused(module& m, instruction_ref ins, F f)
+{
+    if(not m.has_instruction(ins) or not ins->outputs().empty() or ins == std::prev(m.end()))
+        return;
+    if(not ins->get_shape().dynamic() and ins->get_shape().elements() == 0 and
+       ins->name().front() != '@' and not contains({"identity", "allocate"}, ins->name()) and
+       not ins->is_undefined())
+        return;
+    fix([&](auto self, auto leaf) {
+        if(not m.has_instruction(leaf))
+            return;
+        if(not leaf->outputs().empty() or leaf == std::prev(m.end()) or
+           leaf->name() == "@param")
+        {
+            f(leaf);
+            return;
+        }
+        std::unordered_set<instruction_ref> args(leaf->inputs().begin(), leaf->inputs().end());
+        f(leaf);
+        m.remove_instruction(leaf);
+        for(auto arg : args)
+            self(arg);
+    })(ins);
+}
+
+// Add the hits to the pass being recorded, if any
+template <class... Ms>
+void record_hits(const std::vector<std::size_t>& hits, const Ms&... ms)
+{
+    auto* telemetry = pass_telemetry::current();
+    if(telemetry == nullptr)
+        return;
+    std::size_t i = 0;
+    each_args([&](const auto& m) { telemetry->add_matcher_hits(get_type_name(m), hits[i++]); },
+              ms...);
+}
+
+} // namespace detail
+
+/// Find matches for an instruction in the module
+template <class Mod, class... Ms>
+void find_matches(Mod& mod, instruction_ref ins, Ms&&... ms)
+{
+    std::vector<std::unordered_set<std::string>> names(sizeof...(Ms));
+    auto index = detail::match_first(mod, ins, names, [](const auto&) {}, ms...);
+    if(index < 0)
+        return;
+    std::vector<std::size_t> hits(sizeof...(Ms));
+    hits[index]++;
+    detail::record_hits(hits, ms...);
 }
 
 /// Find matches in a module
 template <class Mod, class... Ms>
 void find_matches(Mod& mod, Ms&&... ms)
 {
+    auto names = detail::matcher_root_names(ms...);
+    std::vector<std::size_t> hits(sizeof...(Ms));
     for(auto ins : iterator_for(get_module(mod)))
     {
-        find_matches(mod, ins, ms...);
+        auto index = detail::match_first(mod, ins, names, [](const auto&) {}, ms...);
+        if(index >= 0)
+            hits[index]++;
     }
+    detail::record_hits(hits, ms...);
+}
+
+/// Apply the matchers until none of them match. Every instruction is visited
+/// once, and after a rewrite only the instructions around it are visited
+/// again: the matched instructions with their inputs and outputs, and any
+/// instruction the rewrite created. Instructions left unused by a rewrite are
+/// removed right away so matchers like used_once see the new graph. Returns
+/// how many times each matcher was applied.
+template <class Mod, class... Ms>
+std::vector<std::size_t> find_matches_fixpoint(Mod& mod, Ms&&... ms)
+{
+    module& m  = get_module(mod);
+    auto names = detail::matcher_root_names(ms...);
+    std::vector<std::size_t> hits(sizeof...(Ms));
+    std::deque<instruction_ref> worklist;
+    std::unordered_set<instruction_ref> queued;
+    std::unordered_set<instruction_ref> known;
+    auto push = [&](instruction_ref ins) {
+        if(queued.insert(ins).second)
+            worklist.push_back(ins);
+    };
+    auto push_neighbours = [&](instruction_ref ins, auto f) {
+        for(auto input : ins->inputs())
+            f(input);
+        for(auto output : ins->outputs())
+            f(output);
+    };
+    // Push ins and its neighbours. Instructions the rewrite created are
+    // explored, and the neighbours of the existing instructions they connect
+    // to are pushed as well since those are what the rewrite changed.
+    auto push_around = fix([&](auto self, instruction_ref ins) -> void {
+        push(ins);
+        known.insert(ins);
+        push_neighbours(ins, [&](instruction_ref x) {
+            if(not contains(known, x))
+            {
+                self(x);
+                return;
+            }
+            push(x);
+            push_neighbours(x, [&](instruction_ref y) {
+                if(contains(known, y))
+                    push(y);
+                else
+                    self(y);
+            });
+        });
+    });
+    for(auto ins : iterator_for(m))
+    {
+        push(ins);
+        known.insert(ins);
+    }
+    // Rewrites that undo each other would never reach a fixpoint, so stop
+    // after as many rewrites as running the matchers over the module 8 times
+    std::size_t budget = 8 * m.size();
+    std::size_t total  = 0;
+    while(not worklist.empty() and total < budget)
+    {
+        auto ins = worklist.front();
+        worklist.pop_front();
+        queued.erase(ins);
+        if(not m.has_instruction(ins))
+            continue;
+        std::vector<instruction_ref> touched;
+        std::vector<std::tuple<operation, std::vector<instruction_ref>, std::size_t>> before;
+        auto index = detail::match_first(
+            mod,
+            ins,
+            names,
+            [&](const matcher_result& r) {
+                touched.push_back(r.result);
+                std::transform(r.instructions.begin(),
+                               r.instructions.end(),
+                               std::back_inserter(touched),
+                               [](const auto& p) { return p.second; });
+                auto n = touched.size();
+                for(std::size_t i = 0; i < n; i++)
+                {
+                    touched.insert(
+                        touched.end(), touched[i]->inputs().begin(), touched[i]->inputs().end());
+                    touched.insert(
+                        touched.end(), touched[i]->outputs().begin(), touched[i]->outputs().end());
+                }
+                std::sort(touched.begin(), touched.end(), [](auto x, auto y) {
+                    return std::addressof(*x) < std::addressof(*y);
+                });
+                touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+                std::transform(
+                    touched.begin(), touched.end(), std::back_inserter(before), [](auto x) {
+                        return std::make_tuple(x->get_operator(), x->inputs(), x->outputs().size());
+                    });
+            },
+            ms...);
+        if(index < 0)
+            continue;
+        // Some matchers decide in apply not to rewrite anything, which must
+        // not put the instructions back on the worklist
+        std::size_t i = 0;
+        if(std::all_of(touched.begin(), touched.end(), [&](auto x) {
+               const auto& b = before[i++];
+               return m.has_instruction(x) and x->get_operator() == std::get<0>(b) and
+                      x->inputs() == std::get<1>(b) and x->outputs().size() == std::get<2>(b);
+           }))
+            continue;
+        hits[index]++;
+        total++;
+        for(auto x : touched)
+        {
+            if(m.has_instruction(x))
+                push_around(x);
+        }
+        for(auto x : touched)
+        {
+            detail::remove_unused(m, x, [&](instruction_ref y) {
+                if(y->outputs().empty() and y != std::prev(m.end()) and y->name() != "@param")
+                {
+                    known.erase(y);
+                    queued.erase(y);
+                }
+                else
+                {
+                    push(y);
+                }
+            });
+        }
+    }
+#if !defined(__GNUC__) || defined(__clang__) || __GNUC__ > 5
+    const
+#endif
+        int trace = value_of(MIGRAPHX_TRACE_MATCHES{});
+    if(trace > 0)
+    {
+        int i = 0;
+        each_args(
+            [&](auto&& x) {
+                std::cout << "Hits: " << get_type_name(x) << ": " << hits[i++] << std::endl;
+            },
+            ms...);
+    }
+    detail::record_hits(hits, ms...);
+    return hits;
 }
 
 template <class M, class F>
@@ -453,16 +736,41 @@ struct match_fold_f
         return p([&](auto... ms) { return match_fold_f::fold_matchers(ctx, ins, ms...); });
     }
 
+    // all_of can only match the names of any matcher that has them, while
+    // any_of can match the names of all of its matchers
+    template <class... Ms>
+    static std::unordered_set<std::string> fold_root_names(const Ms&... ms)
+    {
+        std::vector<std::unordered_set<std::string>> names = {match::root_names(ms)...};
+        if(not Matches or names.empty())
+            return {};
+        if(std::is_same<Op, lazy_and>{})
+        {
+            auto it = std::find_if(
+                names.begin(), names.end(), [](const auto& n) { return not n.empty(); });
+            if(it == names.end())
+                return {};
+            return *it;
+        }
+        if(std::any_of(names.begin(), names.end(), [](const auto& n) { return n.empty(); }))
+            return {};
+        std::unordered_set<std::string> result;
+        for(const auto& n : names)
+            result.insert(n.begin(), n.end());
+        return result;
+    }
+
     template <class... Ts>
     auto operator()(Ts... ms) const
     {
-        return make_bf_matcher(
-            [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
-                bool matches = match_fold_f::fold_matchers(ctx, ins, ms...);
-                if(matches == Matches)
-                    return {ins};
-                return nullopt;
-            });
+        auto f = [=](matcher_context& ctx, instruction_ref ins) -> optional<instruction_ref> {
+            bool matches = match_fold_f::fold_matchers(ctx, ins, ms...);
+            if(matches == Matches)
+                return {ins};
+            return nullopt;
+        };
+        return make_bindable_matcher(
+            make_root_name_matcher(make_function_matcher(f), fold_root_names(ms...)));
     }
 
     template <class Selector>
@@ -623,8 +931,8 @@ inline auto var(std::string s)
 
 inline auto name(std::string s)
 {
-    return make_basic_pred_matcher(
-        [=, s = std::move(s)](instruction_ref ins) { return ins->name() == s; });
+    auto p = [=](instruction_ref ins) { return ins->name() == s; };
+    return make_basic_matcher(make_root_name_matcher(predicate_matcher<decltype(p)>{p}, {s}));
 }
 
 inline auto name_contains(const std::string& name)
@@ -635,9 +943,9 @@ inline auto name_contains(const std::string& name)
 
 inline auto name(std::unordered_set<std::string> names)
 {
-    return make_basic_pred_matcher([=, names = std::move(names)](instruction_ref ins) {
-        return names.count(ins->name()) > 0;
-    });
+    auto p = [=](instruction_ref ins) { return names.count(ins->name()) > 0; };
+    return make_basic_matcher(
+        make_root_name_matcher(predicate_matcher<decltype(p)>{p}, std::move(names)));
 }
 
 template <class... Ts>
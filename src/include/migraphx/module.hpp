@@ -183,6 +183,11 @@ struct module
     bool has_instruction(instruction_ref ins) const;
 
     std::size_t size() const;
+
+    /// Changes whenever instructions are added, removed, moved or replaced
+    /// through the module. Changes made directly to an instruction are not
+    /// tracked.
+    std::size_t version() const;
     instruction_ref begin() const;
     instruction_ref end() const;
 
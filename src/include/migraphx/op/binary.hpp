@@ -59,6 +59,13 @@ struct binary : op_name<Derived>
         return {{"pointwise", true}, {"point_op", self.point_op()}};
     }
     value attributes() const { return base_attributes(); }
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty() or inputs.front().dynamic())
+            return 0;
+        return inputs.front().elements();
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         check_shapes{inputs, static_cast<const Derived&>(*this), true}
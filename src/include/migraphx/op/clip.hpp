@@ -46,6 +46,14 @@ struct clip
                 {"point_op", "${function:min}(${function:max}(${1}, ${0}), ${2})"}};
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty() or inputs.front().dynamic())
+            return 0;
+        // A min and a max for each element
+        return 2 * inputs.front().elements();
+    }
+
     shape compute_shape(std::vector<shape> inputs) const
     {
         check_shapes{inputs, *this}.has(3).same_type().same_dims();
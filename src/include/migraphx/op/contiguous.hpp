@@ -65,9 +65,8 @@ struct contiguous
         assert(dyn_out.computed_shape.standard());
         argument result{dyn_out.computed_shape};
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(output.get_shape(), [&](const auto& idx) {
-                output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
-            });
+            shape_for_each_offset(output.get_shape(), input.get_shape())(
+                [&](auto i, auto j) { output.data()[i] = input.data()[j]; });
         });
         return result;
     }
@@ -196,6 +196,15 @@ struct convolution
         return x_shape.with_lens(output_lens);
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.size() < 2 or inputs[0].dynamic() or inputs[1].dynamic())
+            return 0;
+        // Each output element is a multiply-add over the filter of one output channel
+        const auto& w = inputs[1];
+        return 2 * normalize_compute_shape(inputs).elements() * (w.elements() / w.lens()[0]);
+    }
+
     size_t kdims() const
     {
         check_attribute_size();
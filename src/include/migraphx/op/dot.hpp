@@ -99,6 +99,14 @@ struct dot
         }
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.size() < 2 or inputs[0].dynamic() or inputs[1].dynamic())
+            return 0;
+        // A multiply and an add for each element of the inner dimension
+        return 2 * compute_shape(inputs).elements() * inputs[0].lens().back();
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result = argument{dyn_out.computed_shape};
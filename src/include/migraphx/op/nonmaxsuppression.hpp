@@ -24,18 +24,18 @@
 #ifndef MIGRAPHX_GUARD_OPERATORS_NONMAXSUPPRESSION_HPP
 #define MIGRAPHX_GUARD_OPERATORS_NONMAXSUPPRESSION_HPP
 
+#include <algorithm>
 #include <cmath>
-#include <queue>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <vector>
 #include <migraphx/config.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/float_equal.hpp>
-#include <migraphx/algorithm.hpp>
 #include <migraphx/tensor_view.hpp>
-#include <migraphx/shape_for_each.hpp>
 #include <migraphx/check_shapes.hpp>
-#include <migraphx/output_iterator.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/argument.hpp>
 
 namespace migraphx {
@@ -186,63 +186,70 @@ struct nonmaxsuppression
         return result;
     }
 
-    inline bool suppress_by_iou(box b1, box b2, double iou_threshold) const
+    // Corners and areas of boxes stored as separate arrays, so the IoU loop
+    // can be vectorized
+    struct box_list
     {
-        b1.sort();
-        b2.sort();
+        std::vector<double> x0;
+        std::vector<double> x1;
+        std::vector<double> y0;
+        std::vector<double> y1;
+        std::vector<double> area;
 
-        box intersection{};
-        for(auto i : range(2))
-        {
-            intersection[i][0] = std::max(b1[i][0], b2[i][0]);
-            intersection[i][1] = std::min(b1[i][1], b2[i][1]);
-            if(intersection[i][0] > intersection[i][1])
-            {
-                return false;
-            }
-        }
+        explicit box_list(std::size_t n = 0) : x0(n), x1(n), y0(n), y1(n), area(n) {}
 
-        const double area1             = b1.area();
-        const double area2             = b2.area();
-        const double intersection_area = intersection.area();
-        const double union_area        = area1 + area2 - intersection_area;
+        std::size_t size() const { return area.size(); }
 
-        if(area1 <= .0f or area2 <= .0f or union_area <= .0f)
+        void set(std::size_t i, box b)
         {
-            return false;
+            b.sort();
+            x0[i]   = b.x[0];
+            x1[i]   = b.x[1];
+            y0[i]   = b.y[0];
+            y1[i]   = b.y[1];
+            area[i] = b.area();
         }
 
-        const double intersection_over_union = intersection_area / union_area;
-
-        return intersection_over_union > iou_threshold;
-    }
+        void set(std::size_t i, const box_list& other, std::size_t j)
+        {
+            x0[i]   = other.x0[j];
+            x1[i]   = other.x1[j];
+            y0[i]   = other.y0[j];
+            y1[i]   = other.y1[j];
+            area[i] = other.area[j];
+        }
+    };
 
-    // filter boxes below score_threshold
-    template <class T>
-    std::priority_queue<std::pair<double, int64_t>>
-    filter_boxes_by_score(T scores_start, std::size_t num_boxes, double score_threshold) const
+    // Marks the boxes after box i whose IoU with it exceeds the threshold
+    static void suppress_by_iou(const box_list& boxes,
+                                std::size_t i,
+                                double iou_threshold,
+                                std::vector<std::uint8_t>& suppressed)
     {
-        std::priority_queue<std::pair<double, int64_t>> boxes_heap;
-        auto insert_to_boxes_heap =
-            make_function_output_iterator([&](const auto& x) { boxes_heap.push(x); });
-        int64_t box_idx = 0;
-        transform_if(
-            scores_start,
-            scores_start + num_boxes,
-            insert_to_boxes_heap,
-            [&](auto sc) {
-                box_idx++;
-                return sc >= score_threshold;
-            },
-            [&](auto sc) { return std::make_pair(sc, box_idx - 1); });
-        return boxes_heap;
+        const double x0 = boxes.x0[i];
+        const double x1 = boxes.x1[i];
+        const double y0 = boxes.y0[i];
+        const double y1 = boxes.y1[i];
+        const double a  = boxes.area[i];
+        for(std::size_t j = i + 1; j < boxes.size(); j++)
+        {
+            const double ix0               = std::max(boxes.x0[j], x0);
+            const double ix1               = std::min(boxes.x1[j], x1);
+            const double iy0               = std::max(boxes.y0[j], y0);
+            const double iy1               = std::min(boxes.y1[j], y1);
+            const double intersection_area = (ix1 - ix0) * (iy1 - iy0);
+            const double union_area        = boxes.area[j] + a - intersection_area;
+            const bool overlap             = ix0 <= ix1 and iy0 <= iy1;
+            const bool valid = boxes.area[j] > 0.0 and a > 0.0 and union_area > 0.0;
+            suppressed[j] |= static_cast<std::uint8_t>(
+                overlap and valid and intersection_area / union_area > iou_threshold);
+        }
     }
 
     template <class Output, class Boxes, class Scores>
     std::size_t compute_nms(Output output,
                             Boxes boxes,
                             Scores scores,
-                            const shape& max_output_shape,
                             std::size_t max_output_boxes_per_class,
                             double iou_threshold,
                             double score_threshold) const
@@ -252,50 +259,55 @@ struct nonmaxsuppression
         const auto num_batches = lens[0];
         const auto num_classes = lens[1];
         const auto num_boxes   = lens[2];
-        // boxes of a class with NMS applied [score, index]
-        std::vector<std::pair<double, int64_t>> selected_boxes_inside_class;
-        std::vector<int64_t> selected_indices;
-        selected_boxes_inside_class.reserve(max_output_shape.elements());
-        // iterate over batches and classes
-        shape comp_s{shape::double_type, {num_batches, num_classes}};
-        shape_for_each(comp_s, [&](auto idx) {
-            auto batch_idx = idx[0];
-            auto class_idx = idx[1];
-            // index offset for this class
-            auto scores_start = scores.begin() + (batch_idx * num_classes + class_idx) * num_boxes;
-            // iterator to first value of this batch
+
+        // The boxes are shared by all the classes of a batch
+        std::vector<box_list> batch_boxes(num_batches);
+        par_for(num_batches, 1, [&](auto batch_idx) {
+            batch_boxes[batch_idx] = box_list{num_boxes};
             auto batch_boxes_start = boxes.begin() + batch_idx * num_boxes * 4;
-            auto boxes_heap = filter_boxes_by_score(scores_start, num_boxes, score_threshold);
-            selected_boxes_inside_class.clear();
-            while(not boxes_heap.empty() &&
-                  selected_boxes_inside_class.size() < max_output_boxes_per_class)
+            for(std::size_t i = 0; i < num_boxes; i++)
+                batch_boxes[batch_idx].set(i, batch_box(batch_boxes_start, i));
+        });
+
+        // selected [batch, class, box] triples for each batch and class
+        std::vector<std::vector<int64_t>> selected(num_batches * num_classes);
+        par_for(num_batches * num_classes, 1, [&](auto i) {
+            const auto batch_idx = i / num_classes;
+            const auto class_idx = i % num_classes;
+            auto scores_start    = scores.begin() + i * num_boxes;
+            // [score, index] of the boxes above the score threshold, ordered
+            // from the highest score with ties going to the higher index
+            std::vector<std::pair<double, int64_t>> candidates;
+            for(std::size_t j = 0; j < num_boxes; j++)
             {
-                // select next top scorer box and remove any boxes from boxes_heap that exceeds IOU
-                // threshold with the selected box
-                const auto next_top_score = boxes_heap.top();
-                boxes_heap.pop();
-                selected_boxes_inside_class.push_back(next_top_score);
-                selected_indices.push_back(batch_idx);
-                selected_indices.push_back(class_idx);
-                selected_indices.push_back(next_top_score.second);
-                std::priority_queue<std::pair<double, int64_t>> remainder_boxes;
-                while(not boxes_heap.empty())
-                {
-                    auto iou_candidate_box = boxes_heap.top();
-                    if(not this->suppress_by_iou(
-                           batch_box(batch_boxes_start, iou_candidate_box.second),
-                           batch_box(batch_boxes_start, next_top_score.second),
-                           iou_threshold))
-                    {
-                        remainder_boxes.push(iou_candidate_box);
-                    }
-                    boxes_heap.pop();
-                }
-                boxes_heap = remainder_boxes;
+                if(scores_start[j] >= score_threshold)
+                    candidates.emplace_back(scores_start[j], j);
+            }
+            std::sort(candidates.begin(), candidates.end(), std::greater<>{});
+
+            box_list candidate_boxes{candidates.size()};
+            for(std::size_t j = 0; j < candidates.size(); j++)
+                candidate_boxes.set(j, batch_boxes[batch_idx], candidates[j].second);
+
+            std::vector<std::uint8_t> suppressed(candidates.size(), 0);
+            std::size_t num_selected = 0;
+            for(std::size_t j = 0; j < candidates.size(); j++)
+            {
+                if(suppressed[j] != 0)
+                    continue;
+                selected[i].push_back(batch_idx);
+                selected[i].push_back(class_idx);
+                selected[i].push_back(candidates[j].second);
+                if(++num_selected == max_output_boxes_per_class)
+                    break;
+                suppress_by_iou(candidate_boxes, j, iou_threshold, suppressed);
             }
         });
-        std::copy(selected_indices.begin(), selected_indices.end(), output.begin());
-        return selected_indices.size() / 3;
+
+        auto out = output.begin();
+        for(const auto& indices : selected)
+            out = std::copy(indices.begin(), indices.end(), out);
+        return std::distance(output.begin(), out) / 3;
     }
 
     argument compute(const shape& output_shape, std::vector<argument> args) const
@@ -319,7 +331,6 @@ struct nonmaxsuppression
                 num_selected = compute_nms(output,
                                            boxes,
                                            scores,
-                                           max_output_shape,
                                            max_output_boxes_per_class,
                                            iou_threshold,
                                            score_threshold);
@@ -30,6 +30,8 @@
 #include <migraphx/permutation.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -63,6 +65,88 @@ struct pointwise
         return shape::from_permutation(type, inputs.front().lens(), find_permutation(inputs));
     }
 
+    // A step of the submodule evaluated over a block of elements at once
+    struct step
+    {
+        instruction_ref ins;
+        std::vector<std::size_t> inputs;
+    };
+
+    // The steps of the submodule, and the one whose result is its output
+    struct step_plan
+    {
+        std::vector<step> steps;
+        std::size_t output = 0;
+    };
+
+    // Flatten the submodule into steps that can be evaluated directly on
+    // tensors. No steps are returned when an operator needs a context.
+    static step_plan make_steps(const module& pm)
+    {
+        step_plan plan;
+        auto& steps = plan.steps;
+        std::unordered_map<instruction_ref, std::size_t> slots;
+        for(auto ins : iterator_for(pm))
+        {
+            if(ins->name() == "@return")
+            {
+                // The returned value is not always the last instruction
+                if(ins->inputs().size() != 1 or not contains(slots, ins->inputs().front()))
+                    return {};
+                plan.output = slots.at(ins->inputs().front());
+                return plan;
+            }
+            if(ins->name() != "@param" and ins->name() != "@literal" and
+               not is_context_free(ins->get_operator()))
+                return {};
+            step st{ins, {}};
+            for(auto input : ins->inputs())
+            {
+                if(not contains(slots, input))
+                    return {};
+                st.inputs.push_back(slots.at(input));
+            }
+            slots[ins] = steps.size();
+            steps.push_back(st);
+        }
+        if(not steps.empty())
+            plan.output = steps.size() - 1;
+        return plan;
+    }
+
+    // Evaluate the steps where each input is viewed with the same lens
+    static argument eval_steps(const step_plan& plan,
+                               const std::unordered_map<instruction_ref, argument>& inputs)
+    {
+        const auto& steps = plan.steps;
+        std::vector<argument> results(steps.size());
+        std::vector<argument> values;
+        for(std::size_t i = 0; i < steps.size(); i++)
+        {
+            const auto& st = steps[i];
+            auto it        = inputs.find(st.ins);
+            if(it != inputs.end())
+            {
+                results[i] = it->second;
+                continue;
+            }
+            values.resize(st.inputs.size());
+            std::transform(st.inputs.begin(),
+                           st.inputs.end(),
+                           values.begin(),
+                           [&](std::size_t j) { return results[j]; });
+            const auto& op = st.ins->get_operator();
+            results[i]     = op.compute(op.compute_shape(to_shapes(values)), values);
+        }
+        return results[plan.output];
+    }
+
+    static argument broadcast_to(const argument& a, const shape& s)
+    {
+        return {shape{a.get_shape().type(), s.lens(), std::vector<std::size_t>(s.ndim(), 0)},
+                a.data()};
+    }
+
     argument compute(const shape& output_shape,
                      const std::vector<argument>& args,
                      const std::vector<module_ref>& mods,
@@ -74,7 +158,89 @@ struct pointwise
         auto pnames = pm->get_parameter_names();
         std::sort(pnames.begin(), pnames.end());
 
-        par_for(output_shape.elements(), [&](auto i) {
+        auto plan = make_steps(*pm);
+        if(plan.steps.empty() or output_shape.dynamic())
+            return compute_elements(output, args, pm, pnames, run);
+
+        std::vector<instruction_ref> param_args;
+        std::transform(pnames.begin(),
+                       pnames.end(),
+                       std::back_inserter(param_args),
+                       [&](const auto& name) { return pm->get_parameter(name); });
+        std::vector<argument> literals;
+        std::vector<instruction_ref> literal_ins;
+        for(const auto& st : plan.steps)
+        {
+            if(st.ins->name() != "@literal")
+                continue;
+            // Only scalar literals can be broadcasted across the elements
+            if(st.ins->get_shape().elements() != 1)
+                return compute_elements(output, args, pm, pnames, run);
+            literals.push_back(st.ins->get_literal().get_argument());
+            literal_ins.push_back(st.ins);
+        }
+
+        auto same_layout = [&](const argument& a) {
+            const auto& s = a.get_shape();
+            return s.lens() == output_shape.lens() and s.strides() == output_shape.strides();
+        };
+        auto is_scalar = [](const argument& a) { return a.get_shape().scalar(); };
+        auto bind = [&](const shape& s, auto f) {
+            std::unordered_map<instruction_ref, argument> inputs;
+            for(std::size_t i = 0; i < args.size(); i++)
+                inputs[param_args[i]] = f(args[i]);
+            for(std::size_t i = 0; i < literals.size(); i++)
+                inputs[literal_ins[i]] = broadcast_to(literals[i], s);
+            return inputs;
+        };
+
+        if(output_shape.packed() and
+           all_of(args, [&](const auto& a) { return same_layout(a) or is_scalar(a); }))
+        {
+            // All the inputs share the layout of the output, so the data can be
+            // processed as contiguous blocks of the underlying buffer
+            const std::size_t block = 4096;
+            auto n                  = output_shape.element_space();
+            auto nblocks            = (n + block - 1) / block;
+            par_for(nblocks, 1, [&](auto b) {
+                auto start = b * block;
+                shape bs{output_shape.type(), {std::min(block, n - start)}};
+                auto inputs = bind(bs, [&](const argument& a) -> argument {
+                    if(is_scalar(a))
+                        return broadcast_to(a, bs);
+                    return {shape{a.get_shape().type(), bs.lens()},
+                            a.data() + start * a.get_shape().type_size()};
+                });
+                argument out{bs, output.data() + start * output_shape.type_size()};
+                auto result = eval_steps(plan, inputs);
+                visit_all(out, result)(
+                    [&](auto y, auto x) { std::copy(x.begin(), x.end(), y.begin()); });
+            });
+        }
+        else
+        {
+            // Evaluate the whole tensor at once with the inputs in their own layout
+            auto inputs = bind(output_shape, [&](const argument& a) -> argument {
+                if(is_scalar(a))
+                    return broadcast_to(a, output_shape);
+                return a;
+            });
+            auto result = eval_steps(plan, inputs);
+            visit_all(output, result)(
+                [&](auto y, auto x) { std::copy(x.begin(), x.end(), y.begin()); });
+        }
+        return output;
+    }
+
+    // Evaluate the submodule for each element separately
+    template <class F>
+    static argument compute_elements(argument output,
+                                     const std::vector<argument>& args,
+                                     module_ref pm,
+                                     const std::vector<std::string>& pnames,
+                                     const F& run)
+    {
+        par_for(output.get_shape().elements(), [&](auto i) {
             std::unordered_map<std::string, argument> params;
 
             std::transform(
@@ -33,6 +33,7 @@
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/dyn_output.hpp>
 #include <cmath>
+#include <numeric>
 #include <utility>
 
 namespace migraphx {
@@ -266,6 +267,23 @@ struct pooling
         });
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty() or inputs.front().dynamic())
+            return 0;
+        const auto& input = inputs.front();
+        // Each output element reduces over a window of the input
+        std::size_t window = dyn_global ? std::accumulate(input.lens().begin() + 2,
+                                                          input.lens().end(),
+                                                          std::size_t{1},
+                                                          std::multiplies<>{})
+                                        : std::accumulate(lengths.begin(),
+                                                          lengths.end(),
+                                                          std::size_t{1},
+                                                          std::multiplies<>{});
+        return normalize_compute_shape(inputs).elements() * window;
+    }
+
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
@@ -109,6 +109,15 @@ struct quant_convolution
         return inputs[0].with_lens(t, output_lens);
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.size() < 2 or inputs[0].dynamic() or inputs[1].dynamic())
+            return 0;
+        // Each output element is a multiply-add over the filter of one output channel
+        const auto& w = inputs[1];
+        return 2 * normalize_compute_shape(inputs).elements() * (w.elements() / w.lens()[0]);
+    }
+
     size_t kdims() const
     {
         check_attribute_size();
@@ -75,6 +75,14 @@ struct quant_dot
         out_lens[dim_1] = b.lens()[dim_1];
         return {shape::int32_type, out_lens};
     }
+
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.size() < 2 or inputs[0].dynamic() or inputs[1].dynamic())
+            return 0;
+        // A multiply and an add for each element of the inner dimension
+        return 2 * compute_shape(inputs).elements() * inputs[0].lens().back();
+    }
 };
 
 } // namespace op
@@ -143,6 +143,13 @@ struct reduce_op : op_name<Derived>
         }
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty() or inputs.front().dynamic())
+            return 0;
+        return inputs.front().elements();
+    }
+
     template <class T>
     void tune_dims(const std::vector<int64_t>& tuned_axes,
                    const std::vector<T>& in_lens,
@@ -154,27 +161,6 @@ struct reduce_op : op_name<Derived>
         }
     }
 
-    template <class T>
-    void reduce(tensor_view<T>& input,
-                shape& batch_shape,
-                std::vector<int64_t>& tuned_axes,
-                std::vector<std::size_t>& out_idx,
-                tensor_view<T>& output) const
-    {
-        using accumulator = accumulator_type<T>;
-        auto& self        = static_cast<const Derived&>(*this);
-        auto data_idx     = out_idx;
-        accumulator val   = self.init();
-        shape_for_each(batch_shape, [&](auto b_idx) {
-            this->tune_dims(tuned_axes, b_idx, data_idx);
-            accumulator x = input(data_idx.begin(), data_idx.end());
-            val           = self.op()(accumulator{self.input()(x)}, val);
-        });
-
-        output(out_idx.begin(), out_idx.end()) =
-            static_cast<const Derived&>(*this).output(batch_shape)(val);
-    }
-
     argument compute(const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
@@ -182,11 +168,26 @@ struct reduce_op : op_name<Derived>
         auto tuned_axes = tune_axes(arg_lens.size());
         std::vector<std::size_t> batch_lens(dyn_out.computed_shape.lens().size(), 1);
         tune_dims(tuned_axes, arg_lens, batch_lens);
-        shape batch_shape{dyn_out.computed_shape.type(), batch_lens};
+        auto t = dyn_out.computed_shape.type();
+        shape batch_shape{t, batch_lens};
+        // Walk the input directly: the window covers the reduced axes and the
+        // outer shape maps each output element to the start of its window
+        const auto& in_strides = args.front().get_shape().strides();
+        shape window_shape{t, batch_lens, in_strides};
+        shape outer_shape{t, dyn_out.computed_shape.lens(), in_strides};
+        auto for_each_window = shape_for_each_offset(window_shape);
         visit_all(result, args[0])([&](auto output, auto input) {
+            using accumulator = accumulator_type<typename decltype(input)::value_type>;
+            auto& self        = static_cast<const Derived&>(*this);
+            auto out_f        = self.output(batch_shape);
             par_for(dyn_out.computed_shape.elements(), [&](auto i) {
-                auto out_idx = dyn_out.computed_shape.multi(i);
-                this->reduce(input, batch_shape, tuned_axes, out_idx, output);
+                const auto* data = input.data() + outer_shape.index(i);
+                accumulator val  = self.init();
+                for_each_window([&](auto j) {
+                    accumulator x = data[j];
+                    val           = self.op()(accumulator{self.input()(x)}, val);
+                });
+                output[i] = out_f(val);
             });
         });
 
@@ -65,6 +65,14 @@ struct softmax
         }
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty() or inputs.front().dynamic())
+            return 0;
+        // A max, a subtract, an exp, a sum and a divide for each element
+        return 5 * inputs.front().elements();
+    }
+
     auto output() const
     {
         return [=](auto x, auto y) { return x / y; };
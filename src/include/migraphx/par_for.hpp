@@ -24,6 +24,8 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_PAR_FOR_HPP
 #define MIGRAPHX_GUARD_RTGLIB_PAR_FOR_HPP
 
+#include <migraphx/thread_pool.hpp>
+#include <atomic>
 #include <thread>
 #include <cmath>
 #include <algorithm>
@@ -72,37 +74,29 @@ void par_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
     else
     {
-        std::vector<joinable_thread> threads(threadsize);
-// Using const here causes gcc 5 to ICE
-#if(!defined(__GNUC__) || __GNUC__ != 5)
-        const
-#endif
-            std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::size_t tid  = 0;
-        std::generate(threads.begin(), threads.end(), [=, &work, &tid] {
-            auto result = joinable_thread([=] {
-                std::size_t start = work;
-                std::size_t last  = std::min(n, work + grainsize);
+        // Split the work into more chunks than threads, so threads that finish
+        // early take over the chunks left by slower ones
+        const std::size_t grainsize = std::ceil(static_cast<double>(n) / (threadsize * 4));
+        std::atomic<std::size_t> work{0};
+        thread_pool::get().parallel(threadsize, [&](std::size_t tid) {
+            for(std::size_t start = work.fetch_add(grainsize); start < n;
+                start             = work.fetch_add(grainsize))
+            {
+                std::size_t last = std::min(n, start + grainsize);
                 for(std::size_t i = start; i < last; i++)
                 {
                     thread_invoke(i, tid, f);
                 }
-            });
-            work += grainsize;
-            ++tid;
-            return result;
+            }
         });
-        assert(work >= n);
     }
 }
 
 template <class F>
 void par_for(std::size_t n, std::size_t min_grain, F f)
 {
-    const auto threadsize = std::min<std::size_t>(std::thread::hardware_concurrency(),
-                                                  n / std::max<std::size_t>(1, min_grain));
+    const auto threadsize =
+        std::min<std::size_t>(thread_pool::get().size(), n / std::max<std::size_t>(1, min_grain));
     par_for_impl(n, threadsize, f);
 }
 
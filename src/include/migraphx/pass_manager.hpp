@@ -27,6 +27,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/pass.hpp>
 #include <migraphx/tracer.hpp>
+#include <string>
 #include <vector>
 
 namespace migraphx {
@@ -45,6 +46,16 @@ struct module_pass_manager
     virtual ~module_pass_manager() {}
 };
 
+/// A pass that does nothing, which stands in for passes that are disabled
+struct id_pass
+{
+    std::string name() const { return "id"; }
+    void apply(const module&) const {}
+};
+
+/// Returns the pass when it is enabled, otherwise a pass that does nothing
+pass enable_pass(bool enabled, pass p);
+
 void run_passes(module& mod, const std::vector<pass>& passes, tracer trace = tracer{});
 void run_passes(program& prog, const std::vector<pass>& passes, tracer trace = tracer{});
 
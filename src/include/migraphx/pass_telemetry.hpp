@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PASS_TELEMETRY_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PASS_TELEMETRY_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/value.hpp>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/// Measurements of one pass applied to one module
+struct pass_record
+{
+    std::string pass;
+    std::string module;
+    /// Time in milliseconds, which includes the passes it runs itself
+    double time                     = 0;
+    std::size_t instructions_before = 0;
+    std::size_t instructions_after  = 0;
+    /// How many times each matcher rewrote the module during the pass
+    std::unordered_map<std::string, std::size_t> matcher_hits;
+};
+
+/**
+ * Records every pass the pass manager runs on the calling thread while it is
+ * alive. Telemetry objects can be nested, in which case only the innermost
+ * one records.
+ */
+struct pass_telemetry
+{
+    pass_telemetry();
+    pass_telemetry(const pass_telemetry&) = delete;
+    pass_telemetry& operator=(const pass_telemetry&) = delete;
+    ~pass_telemetry();
+
+    /// The telemetry recording on the calling thread, or nullptr
+    static pass_telemetry* current();
+
+    /// Run f, which applies the pass to m, and record it
+    const pass_record& record(const std::string& pass, const module& m, const std::function<void()>& f);
+
+    /// Add hits to a matcher of the pass being recorded
+    void add_matcher_hits(const std::string& matcher, std::size_t n);
+
+    const std::vector<pass_record>& records() const;
+
+    private:
+    std::vector<pass_record> recs;
+    std::size_t active       = -1;
+    pass_telemetry* previous = nullptr;
+};
+
+/// Records as an array of objects, for the json exporter
+value pass_records_to_value(const std::vector<pass_record>& records);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PASS_TELEMETRY_HPP
@@ -27,6 +27,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
 #include <string>
+#include <iosfwd>
 #include <memory>
 
 namespace migraphx {
@@ -50,6 +51,9 @@ struct process
 
     void exec();
 
+    // Writes the output of the command to os instead of stdout
+    void exec(std::ostream& os);
+
     private:
     std::unique_ptr<process_impl> impl;
 };
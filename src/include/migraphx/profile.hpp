@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PROFILE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PROFILE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/value.hpp>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Measurements of an instruction averaged over the profiled runs
+struct instruction_profile
+{
+    instruction_ref ins;
+    /// The instruction as it is printed by the program
+    std::string text;
+    /// Group used to summarize the time by operator
+    std::string group;
+    /// Time in milliseconds
+    double time = 0;
+    /// Memory traffic derived from the shapes of the inputs and output
+    std::size_t bytes_read    = 0;
+    std::size_t bytes_written = 0;
+    /// Floating point operations estimated from the shapes
+    std::size_t flops = 0;
+    /// Hardware counters, when they are enabled and supported
+    std::vector<std::pair<std::string, double>> counters;
+
+    double gbytes_per_second() const;
+    double gflops_per_second() const;
+};
+
+/// Bytes read and written by the instruction, from operation::bytes, or
+/// zero for builtins, allocations and views
+std::pair<std::size_t, std::size_t> estimate_bytes(instruction_ref ins);
+
+/// Floating point operations reported by the operator of the instruction,
+/// or by the number of operators in the module of a pointwise instruction
+std::size_t estimate_flops(instruction_ref ins);
+
+/// Work of the instructions of a group, estimated from their shapes
+struct operation_cost
+{
+    std::string group;
+    std::size_t instructions = 0;
+    std::size_t flops        = 0;
+    std::size_t bytes        = 0;
+
+    /// Floating point operations for each byte read or written
+    double arithmetic_intensity() const;
+};
+
+/// Print one line for each group followed by the total
+void print_cost_model(std::ostream& os, const std::vector<operation_cost>& costs);
+
+/**
+ * Hardware counters of the process, read with perf_event_open on Linux. The
+ * counters are opened for each thread the process has when they are
+ * created, such as the workers of the thread pool, and stop() returns their
+ * sum. Threads started later are not counted. When the counters can not be
+ * opened, such as without the permission to do so, enabled() returns false
+ * and stop() returns no counters.
+ */
+struct hardware_counters
+{
+    hardware_counters();
+    hardware_counters(const hardware_counters&) = delete;
+    hardware_counters& operator=(const hardware_counters&) = delete;
+    ~hardware_counters();
+
+    bool enabled() const;
+
+    void start();
+    std::vector<std::pair<std::string, std::uint64_t>> stop();
+
+    private:
+    std::vector<std::string> names;
+    // The counters of each thread, led by the first one
+    std::vector<std::vector<int>> groups;
+};
+
+/// Profiles as an array of objects, for the json exporter
+value profile_to_value(const std::vector<instruction_profile>& profiles);
+
+/// Profiles as a Chrome trace, with the instructions laid out one after the
+/// other in the order they were first run
+value profile_to_chrome_trace(const std::vector<instruction_profile>& profiles);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PROFILE_HPP
@@ -38,6 +38,7 @@
 #include <migraphx/env.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/execution_environment.hpp>
+#include <migraphx/profile.hpp>
 #include <algorithm>
 #include <iostream>
 
@@ -77,6 +78,14 @@ struct program
 
     std::unordered_map<std::string, shape> get_parameter_shapes() const;
 
+    /// Run the program. It can be called from several threads at once: a call
+    /// that finds the context in use by another one, or that is made from
+    /// another thread than the first one to run the program, runs with a fork
+    /// of the context and preallocated memory of its own, which are kept for
+    /// the next calls. Outputs in the preallocated memory of the program are
+    /// valid until the next call from the same thread, unless `exec_env.detach`
+    /// is set, while the outputs in the memory of a fork are always copied
+    /// before they are returned.
     std::vector<argument> eval(parameter_map params,
                                execution_environment exec_env = execution_environment{}) const;
     std::size_t size() const;
@@ -94,16 +103,38 @@ struct program
 
     bool is_compiled() const;
 
+    /// Whether eval can use the execution plan built by finalize
+    bool has_eval_plan() const;
+
     void finalize();
 
+    /// Run the program n times, measuring each instruction
+    std::vector<instruction_profile>
+    profile(parameter_map params, std::size_t n, bool use_hardware_counters = false) const;
+
     void
     perf_report(std::ostream& os, std::size_t n, parameter_map params, std::size_t batch = 1) const;
+    /// Report using the profiles of the instructions from profile
+    void perf_report(std::ostream& os,
+                     std::size_t n,
+                     parameter_map params,
+                     std::size_t batch,
+                     const std::vector<instruction_profile>& profiles) const;
+
+    /// Work of the program estimated from the shapes without running it,
+    /// grouped like the perf report and sorted by the floating point operations
+    std::vector<operation_cost> cost_model() const;
 
     void mark(const parameter_map& params, marker&& m);
 
     value to_value() const;
     void from_value(const value& v);
 
+    /// Serialize the program, using save_literal to produce the value stored for each literal
+    value to_value(const std::function<value(const literal&)>& save_literal) const;
+    /// Load the program, using load_literal to create the literals from their stored values
+    void from_value(const value& v, const std::function<literal(const value&)>& load_literal);
+
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
     void print(std::unordered_map<instruction_ref, std::string>& names,
@@ -0,0 +1,80 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PROGRAM_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PROGRAM_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/kernel_cache.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/program.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct program_cache_stats
+{
+    std::size_t hits   = 0;
+    std::size_t misses = 0;
+};
+
+/**
+ * Directory store of compiled programs, which program::compile uses to skip
+ * the compilation of a program it has already compiled in this or another
+ * process. Entries are written atomically, and the least recently used are
+ * removed when the store grows past its size.
+ */
+struct program_cache
+{
+    kernel_cache store;
+
+    bool enabled() const { return store.enabled(); }
+
+    /// The compiled program, or nothing when there is no entry or it can not
+    /// be loaded
+    optional<program> get(const std::string& key) const;
+
+    void put(const std::string& key, const program& p) const;
+};
+
+/// Key of the compiled program, from the hash of the uncompiled program, the
+/// target and its context, the compile options, the host cpu, the compiler
+/// and full version the library was built with, and the MIGRAPHX_ variables
+/// that are set
+std::string
+program_cache_key(const program& p, const target& t, const compile_options& options = {});
+
+/// The cache in the directory set by MIGRAPHX_PROGRAM_CACHE_PATH, which is
+/// limited to MIGRAPHX_PROGRAM_CACHE_SIZE megabytes (4096 by default). It is
+/// disabled when the path is not set. program::compile does not use it when
+/// compile_options::program_cache is false.
+program_cache get_program_cache();
+
+/// Hits and misses of program::compile in this process
+program_cache_stats get_program_cache_stats();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PROGRAM_CACHE_HPP
@@ -40,11 +40,44 @@ struct program;
 
 void quantize_fp16(program& prog, const std::vector<std::string>& ins_names = {"all"});
 
+/// How the range of the int8 values is chosen from the calibration data
+enum class int8_calibration
+{
+    /// Largest absolute value
+    max,
+    /// Percentile of the absolute values, which ignores rare outliers
+    percentile,
+    /// Range that minimizes the KL divergence between the histograms of the
+    /// original and the quantized values
+    entropy
+};
+
+struct quantize_int8_options
+{
+    std::vector<std::string> ins_names = {"dot", "convolution"};
+    int8_calibration calibration       = int8_calibration::max;
+    /// Percentile used by the percentile calibration
+    double percentile = 99.99;
+    /// Use a scale for each output channel of constant weights, instead of
+    /// a single scale computed from the calibration data
+    bool per_channel_weights = false;
+};
+
+/// The absolute value that the calibration maps to 127, from the values an
+/// input takes in each batch of the calibration data
+double int8_calibration_threshold(const std::vector<argument>& batches,
+                                  const quantize_int8_options& options = {});
+
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
                    const std::vector<std::string>& ins_names = {"dot", "convolution"});
 
+void quantize_int8(program& prog,
+                   const target& t,
+                   const std::vector<parameter_map>& calibration,
+                   const quantize_int8_options& options);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
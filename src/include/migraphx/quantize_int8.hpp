@@ -55,6 +55,8 @@ struct quantize_int8_pass
 {
     std::vector<std::string> ins_names = {"dot", "convolution"};
     std::vector<std::pair<float, float>> quant_params;
+    /// Quantize constant weights with a scale for each output channel
+    bool per_channel_weights = false;
     std::string name() const { return "quantize_int8"; }
     void apply(module& m) const;
 };
@@ -26,7 +26,11 @@
 
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/functional.hpp>
+#include <migraphx/reduce_dims.hpp>
 #include <algorithm>
+#include <array>
+#include <cassert>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -39,21 +43,97 @@ void shape_for_each(const migraphx::shape& s, F f)
 {
     // Ensure calls to f use const ref to vector
     auto call = [&f](const std::vector<std::size_t>& i) { f(i); };
-    std::vector<std::size_t> indices(s.lens().size());
-    shape ss{s.type(), s.lens()};
-    for(std::size_t i = 0; i < ss.elements(); i++)
+    const auto& lens = s.lens();
+    std::vector<std::size_t> indices(lens.size());
+    const std::size_t n = s.elements();
+    for(std::size_t i = 0; i < n; i++)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
         call(indices);
+        // Increment the last index and carry into the outer ones
+        for(std::size_t d = lens.size(); d > 0; d--)
+        {
+            if(++indices[d - 1] < lens[d - 1])
+                break;
+            indices[d - 1] = 0;
+        }
     }
 }
+
+namespace detail {
+
+template <std::size_t N, class F>
+void for_each_offset(const std::vector<shape>& shapes, F& f)
+{
+    assert(shapes.size() == N);
+    const auto& lens = shapes.front().lens();
+    const auto n     = shapes.front().elements();
+    if(n == 0 or lens.empty())
+        return;
+    const auto nd    = lens.size();
+    const auto inner = lens.back();
+    std::array<std::size_t, N> strides;
+    std::transform(shapes.begin(), shapes.end(), strides.begin(), [](const auto& s) {
+        return s.strides().back();
+    });
+    const bool packed = std::all_of(strides.begin(), strides.end(), [](auto x) { return x == 1; });
+
+    std::array<std::size_t, N> base{};
+    auto row = [&] {
+        // Separate loop when all the strides are 1, so it can be vectorized
+        if(packed)
+        {
+            for(std::size_t i = 0; i < inner; i++)
+                sequence_c<N>([&](auto... ks) { f((base[ks] + i)...); });
+        }
+        else
+        {
+            for(std::size_t i = 0; i < inner; i++)
+                sequence_c<N>([&](auto... ks) { f((base[ks] + i * strides[ks])...); });
+        }
+    };
+    if(nd == 1)
+    {
+        row();
+        return;
+    }
+    std::vector<std::size_t> idx(nd - 1);
+    for(std::size_t outer = n / inner; outer > 0; outer--)
+    {
+        row();
+        // Move the offsets to the next row, carrying into the outer dimensions
+        for(std::size_t d = nd - 1; d > 0; d--)
+        {
+            auto dim = d - 1;
+            for(std::size_t k = 0; k < N; k++)
+                base[k] += shapes[k].strides()[dim];
+            if(++idx[dim] < lens[dim])
+                break;
+            for(std::size_t k = 0; k < N; k++)
+                base[k] -= lens[dim] * shapes[k].strides()[dim];
+            idx[dim] = 0;
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * Iterates in order over the elements of shapes that have the same lens,
+ * calling the function with the offset of the element in each shape:
+ *
+ *     shape_for_each_offset(output_shape, input_shape)([&](auto i, auto j) {...});
+ *
+ * Dimensions that can be merged in every shape are merged once when the
+ * iteration is created, so it can be reused for many calls. The offsets are
+ * updated incrementally instead of being computed from a multi-index.
+ */
+template <class... Shapes>
+auto shape_for_each_offset(const shape& s, const Shapes&... ss)
+{
+    auto shapes = reduce_dims({s, ss...});
+    return [=](auto f) { detail::for_each_offset<sizeof...(Shapes) + 1>(shapes, f); };
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
@@ -0,0 +1,77 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
+
+#include <migraphx/config.hpp>
+#include <functional>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct thread_pool_impl;
+
+/**
+ * A set of persistent worker threads. Each call to parallel is a job that
+ * idle workers join, and the calling thread always takes part in its own job,
+ * so jobs submitted from several threads (or from inside another job) share
+ * the same workers instead of creating more threads.
+ *
+ * Jobs wait in a single queue rather than in a deque for each worker, so this
+ * is not a work-stealing pool. The threads running a job claim its tids one at
+ * a time from a shared counter, which balances uneven tids the way stealing
+ * would, since a job is a flat range with nothing to split further.
+ */
+struct thread_pool
+{
+    thread_pool(std::size_t nthreads, bool affinity = false);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool();
+
+    /// The pool shared by the whole process. Its size is set by
+    /// MIGRAPHX_NUM_THREADS and its workers are pinned to cores when
+    /// MIGRAPHX_THREAD_AFFINITY is set. Workers are only pinned to the cpus
+    /// the process is allowed to run on, and only when there are at least as
+    /// many of them as threads in the pool.
+    static thread_pool& get();
+
+    /// Maximum number of threads that can run a job, including the caller
+    std::size_t size() const;
+
+    /// Call f(tid) for each tid in [0, n), where each call can run on a
+    /// different thread, and wait for all of them to finish. The first
+    /// exception thrown is rethrown in the calling thread.
+    void parallel(std::size_t n, const std::function<void(std::size_t)>& f);
+
+    private:
+    std::unique_ptr<thread_pool_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_THREAD_POOL_HPP
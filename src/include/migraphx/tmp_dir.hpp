@@ -30,6 +30,8 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+std::string unique_string(const std::string& prefix);
+
 struct tmp_dir
 {
     fs::path path;
@@ -0,0 +1,231 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/kernel_cache.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_KERNEL_CACHE_PATH)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_KERNEL_CACHE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_KERNEL_CACHE_MAX_SIZE)
+
+static std::atomic<std::size_t>& cache_hits()
+{
+    static std::atomic<std::size_t> n{0};
+    return n;
+}
+
+static std::atomic<std::size_t>& cache_misses()
+{
+    static std::atomic<std::size_t> n{0};
+    return n;
+}
+
+// FNV-1a is used so the names of the entries are the same across processes
+static std::string hash_key(const std::string& key)
+{
+    std::uint64_t h = 14695981039346656037ull;
+    for(char c : key)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+}
+
+// Remove the least recently used entries, other than keep, until the
+// entries fit in max_size. Other processes can remove entries at the same
+// time, so errors are ignored.
+static void evict(const fs::path& path, std::size_t max_size, const fs::path& keep)
+{
+    struct entry
+    {
+        fs::file_time_type time;
+        std::uintmax_t size;
+        fs::path file;
+    };
+    std::vector<entry> entries;
+    std::uintmax_t total = 0;
+    std::error_code ec;
+    for(fs::directory_iterator it{path, ec}, last; not ec and it != last; it.increment(ec))
+    {
+        auto file = it->path();
+        if(file.extension() != ".bin")
+            continue;
+        std::error_code fec;
+        auto size = fs::file_size(file, fec);
+        auto time = fs::last_write_time(file, fec);
+        if(fec)
+            continue;
+        entries.push_back({time, size, file});
+        total += size;
+    }
+    if(total <= max_size)
+        return;
+    std::sort(entries.begin(), entries.end(), [](const auto& x, const auto& y) {
+        return x.time < y.time;
+    });
+    for(const auto& e : entries)
+    {
+        if(total <= max_size)
+            break;
+        if(e.file == keep)
+            continue;
+        std::error_code rec;
+        if(fs::remove(e.file, rec))
+            total -= e.size;
+    }
+}
+
+// Each entry starts with its key so collisions of the hash are not mistaken for a hit
+mapped_file kernel_cache::map(const std::string& key) const
+{
+    if(not enabled())
+        return {};
+    // Another process can remove the entry at any time, so an entry that can't
+    // be mapped is a miss
+    auto file  = path / (hash_key(key) + ".bin");
+    auto entry = map_file(file.string());
+    if(entry.size <= key.size() or entry.data.get()[key.size()] != 0 or
+       not std::equal(key.begin(), key.end(), entry.data.get()))
+        return {};
+    // The write time orders the entries for eviction
+    if(max_size > 0)
+    {
+        std::error_code ec;
+        fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+    }
+    return entry;
+}
+
+std::vector<char> kernel_cache::get(const std::string& key) const
+{
+    auto entry = this->map(key);
+    if(entry.data == nullptr)
+        return {};
+    return {entry.data.get() + key.size() + 1, entry.data.get() + entry.size};
+}
+
+void kernel_cache::put(const std::string& key, const std::vector<char>& data) const
+{
+    if(not enabled())
+        return;
+    fs::create_directories(path);
+    std::vector<char> buffer(key.begin(), key.end());
+    buffer.push_back(0);
+    buffer.insert(buffer.end(), data.begin(), data.end());
+    // Write to a unique file and then rename it, so another process never
+    // reads a partially written entry
+    auto name    = hash_key(key);
+    auto tmp     = path / (unique_string(name) + ".tmp");
+    bool written = false;
+    {
+        std::ofstream os(tmp.string(), std::ios::binary);
+        os.write(buffer.data(), buffer.size());
+        os.close();
+        written = not os.fail();
+    }
+    // A truncated entry would still pass the check of the key, so it is
+    // removed instead of being renamed
+    std::error_code ec;
+    if(not written or fs::file_size(tmp, ec) != buffer.size())
+    {
+        fs::remove(tmp, ec);
+        MIGRAPHX_THROW("Failed to write kernel cache entry: " + tmp.string());
+    }
+    auto file = path / (name + ".bin");
+    fs::rename(tmp, file, ec);
+    if(ec)
+    {
+        fs::remove(tmp, ec);
+        MIGRAPHX_THROW("Failed to rename kernel cache entry: " + file.string());
+    }
+    if(max_size > 0)
+        evict(path, max_size, file);
+}
+
+std::vector<char>
+kernel_cache::get_or_compile(const std::string& key,
+                             const std::function<std::vector<char>()>& compile) const
+{
+    auto result = this->get(key);
+    if(not result.empty())
+    {
+        cache_hits()++;
+        return result;
+    }
+    cache_misses()++;
+    result = compile();
+    try
+    {
+        this->put(key, result);
+    }
+    catch(const std::exception&)
+    {
+        // A cache that cant be written to should not fail the compilation
+    }
+    return result;
+}
+
+static fs::path kernel_cache_path()
+{
+    auto p = string_value_of(MIGRAPHX_KERNEL_CACHE_PATH{});
+    if(not p.empty())
+        return p;
+    auto xdg_cache = string_value_of("XDG_CACHE_HOME");
+    if(not xdg_cache.empty())
+        return fs::path{xdg_cache} / "migraphx" / "kernels";
+    auto home = string_value_of("HOME");
+    if(not home.empty())
+        return fs::path{home} / ".cache" / "migraphx" / "kernels";
+    return fs::temp_directory_path() / "migraphx-kernels";
+}
+
+kernel_cache get_kernel_cache()
+{
+    if(enabled(MIGRAPHX_DISABLE_KERNEL_CACHE{}))
+        return {};
+    // The size is set in megabytes
+    std::size_t max_size = value_of(MIGRAPHX_KERNEL_CACHE_MAX_SIZE{}, 1024);
+    return {kernel_cache_path(), max_size * 1024 * 1024};
+}
+
+kernel_cache_stats get_kernel_cache_stats() { return {cache_hits(), cache_misses()}; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -25,15 +25,137 @@
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/msgpack.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+// The msgpack format is stored with a header followed by the program's
+// metadata. The literals, and the data held by operators, are stored after
+// the metadata, each one aligned, so the file can be mapped and the data used
+// in place.
+struct file_header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t alignment;
+    std::uint64_t metadata_size;
+};
+static_assert(sizeof(file_header) == 24, "Unexpected padding in file header");
+
+const std::array<char, 8> file_magic = {'M', 'I', 'G', 'R', 'A', 'P', 'H', 'X'};
+const std::uint32_t file_format_version = 1;
+const std::uint32_t file_alignment      = 64;
+
+static std::size_t align_up(std::size_t n, std::size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+static bool is_binary_format(const char* buffer, std::size_t size)
+{
+    return size >= sizeof(file_header) and
+           std::equal(file_magic.begin(), file_magic.end(), buffer);
+}
+
+template <class F>
+static void write_program(const program& p, F write)
+{
+    std::vector<literal> literals;
+    std::size_t data_size = 0;
+    auto save_literal     = [&](const literal& l) -> value {
+        data_size    = align_up(data_size, file_alignment);
+        value result = {{"shape", migraphx::to_value(l.get_shape())}, {"offset", data_size}};
+        data_size += l.get_shape().bytes();
+        literals.push_back(l);
+        return result;
+    };
+    value v;
+    {
+        // The data held by operators, such as the literals written by a target,
+        // is also stored after the metadata
+        raw_data_serializer_scope scope{save_literal, nullptr};
+        v = p.to_value(save_literal);
+    }
+    auto metadata = to_msgpack(v);
+
+    const std::array<char, file_alignment> zeros{};
+    std::size_t pos = 0;
+    auto write_at   = [&](std::size_t offset, const char* data, std::size_t n) {
+        assert(offset >= pos and offset - pos < file_alignment);
+        write(zeros.data(), offset - pos);
+        write(data, n);
+        pos = offset + n;
+    };
+
+    file_header header{file_magic, file_format_version, file_alignment, metadata.size()};
+    write_at(0, reinterpret_cast<const char*>(&header), sizeof(header));
+    write_at(pos, metadata.data(), metadata.size());
+    const std::size_t data_start = align_up(pos, file_alignment);
+    std::size_t offset           = 0;
+    for(const auto& l : literals)
+    {
+        offset = align_up(offset, file_alignment);
+        write_at(data_start + offset, l.data(), l.get_shape().bytes());
+        offset += l.get_shape().bytes();
+    }
+}
+
+// make_literal creates the literal from its shape and the offset of its data
+// in the buffer
+template <class F>
+static program read_program(const char* buffer, std::size_t size, F make_literal)
+{
+    file_header header;
+    std::memcpy(&header, buffer, sizeof(header));
+    if(header.version != file_format_version)
+        MIGRAPHX_THROW("Unsupported file format version: " + std::to_string(header.version));
+    if(header.alignment == 0 or header.metadata_size > size - sizeof(header))
+        MIGRAPHX_THROW("Invalid file header");
+    const std::size_t data_start =
+        align_up(sizeof(header) + header.metadata_size, header.alignment);
+    auto load_literal = [&](const value& v) -> literal {
+        auto s      = migraphx::from_value<shape>(v.at("shape"));
+        auto offset = data_start + v.at("offset").to<std::size_t>();
+        if(offset > size or s.bytes() > size - offset)
+            MIGRAPHX_THROW("Literal data is outside of the file");
+        return make_literal(s, offset);
+    };
+    raw_data_serializer_scope scope{nullptr, load_literal};
+    program p;
+    p.from_value(from_msgpack(buffer + sizeof(header), header.metadata_size), load_literal);
+    return p;
+}
+
 program load(const std::string& filename, const file_options& options)
 {
+    if(options.format == "msgpack")
+    {
+        auto file = map_file(filename);
+        if(file.data != nullptr)
+            return load_mapping(file, 0, options);
+    }
     return load_buffer(read_buffer(filename), options);
 }
+program load_mapping(const mapped_file& file, std::size_t offset, const file_options& options)
+{
+    if(offset > file.size)
+        MIGRAPHX_THROW("Offset is past the end of the mapping");
+    const char* buffer = file.data.get() + offset;
+    std::size_t size   = file.size - offset;
+    if(options.format != "msgpack" or not is_binary_format(buffer, size))
+        return load_buffer(buffer, size, options);
+    // The literals share ownership of the mapping, so it stays alive as long
+    // as any of them do
+    return read_program(buffer, size, [&](const shape& s, std::size_t i) {
+        return literal{s, std::shared_ptr<char>(file.data, file.data.get() + offset + i)};
+    });
+}
 program load_buffer(const std::vector<char>& buffer, const file_options& options)
 {
     return load_buffer(buffer.data(), buffer.size(), options);
@@ -43,6 +165,10 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
     program p;
     if(options.format == "msgpack")
     {
+        if(is_binary_format(buffer, size))
+            return read_program(buffer, size, [&](const shape& s, std::size_t i) {
+                return literal{s, buffer + i};
+            });
         p.from_value(from_msgpack(buffer, size));
     }
     else if(options.format == "json")
@@ -58,19 +184,31 @@ program load_buffer(const char* buffer, std::size_t size, const file_options& op
 
 void save(const program& p, const std::string& filename, const file_options& options)
 {
-    write_buffer(filename, save_buffer(p, options));
+    if(options.format == "msgpack")
+    {
+        // Write directly to the file to avoid holding another copy of the literals
+        std::ofstream os(filename, std::ios::binary);
+        write_program(p, [&](const char* data, std::size_t n) { os.write(data, n); });
+        if(not os)
+            MIGRAPHX_THROW("Error writing file: " + filename);
+    }
+    else
+    {
+        write_buffer(filename, save_buffer(p, options));
+    }
 }
 std::vector<char> save_buffer(const program& p, const file_options& options)
 {
-    value v = p.to_value();
     std::vector<char> buffer;
     if(options.format == "msgpack")
     {
-        buffer = to_msgpack(v);
+        write_program(p, [&](const char* data, std::size_t n) {
+            buffer.insert(buffer.end(), data, data + n);
+        });
     }
     else if(options.format == "json")
     {
-        std::string s = to_json_string(v);
+        std::string s = to_json_string(p.to_value());
         buffer        = std::vector<char>(s.begin(), s.end());
     }
     else
@@ -38,6 +38,7 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
 #include <set>
 #include <utility>
 #include <unordered_set>
@@ -47,14 +48,25 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_FINALIZE)
 
+// Versions are taken from one counter, so a module never has the version of
+// another module or of an earlier state of itself
+static std::size_t next_version()
+{
+    static std::atomic<std::size_t> n{0};
+    return ++n;
+}
+
 struct module_impl
 {
     // A list is used to keep references to an instruction stable
     std::list<instruction> instructions;
     std::unordered_set<instruction*> instruction_set;
     std::string name;
-    uint32_t nparams = 0;
-    bool bypass      = false;
+    uint32_t nparams    = 0;
+    bool bypass         = false;
+    std::size_t version = next_version();
+
+    void changed() { version = next_version(); }
 
     bool contains(instruction_ref ins) const
     {
@@ -69,6 +81,7 @@ struct module_impl
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        changed();
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
@@ -81,6 +94,7 @@ struct module_impl
         instructions.clear();
         instruction_set.clear();
         nparams = 0;
+        changed();
     }
 
     void push_front(const instruction& ins) { insert(instructions.begin(), ins); }
@@ -102,12 +116,14 @@ struct module_impl
     instruction_ref erase(instruction_ref pos)
     {
         instruction_set.erase(std::addressof(*pos));
+        changed();
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        changed();
         return instructions.erase(start, last);
     }
 };
@@ -143,6 +159,7 @@ void module::assign(const module& m)
     if(not impl)
         impl = std::make_unique<module_impl>();
     *impl = *m.impl;
+    impl->changed();
 
     // clear instructions
     if(not impl->instructions.empty())
@@ -300,6 +317,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
     shape r = compute_shape(op, args);
     instruction::replace(ins, op, r, std::move(args));
+    impl->changed();
     assert(ins->valid(begin()));
     return ins;
 }
@@ -313,6 +331,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
     instruction::replace(ins, op, out_shape, std::move(args), std::move(module_args));
+    impl->changed();
     assert(ins->valid(begin()));
     return ins;
 }
@@ -333,6 +352,7 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     {
         return rep;
     }
+    impl->changed();
     // Make a copy of outputs which can be changed when calling replace_argument
     auto outputs = ins->outputs();
     for(auto out : outputs)
@@ -379,6 +399,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
+    impl->changed();
     return src;
 }
 
@@ -488,6 +509,7 @@ instruction_ref module::replace_return(std::vector<instruction_ref> args)
 
     shape r = compute_shape(last->get_operator(), args);
     instruction::replace(last, last->get_operator(), r, std::move(args));
+    impl->changed();
     assert(last->valid(begin()));
 
     return last;
@@ -568,6 +590,7 @@ std::unordered_map<std::string, shape> module::get_parameter_shapes() const
 bool module::has_instruction(instruction_ref ins) const { return impl->contains(ins); }
 
 std::size_t module::size() const { return impl->instructions.size(); }
+std::size_t module::version() const { return impl->version; }
 instruction_ref module::begin() const { return impl->instructions.begin(); }
 instruction_ref module::end() const { return impl->instructions.end(); }
 
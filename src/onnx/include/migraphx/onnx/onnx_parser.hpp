@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/program.hpp>
+#include <migraphx/file_buffer.hpp>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <onnx.pb.h>
@@ -103,6 +104,8 @@ struct onnx_parser
     int64_t opset_version       = 13;
 
     std::unordered_map<std::string, op_func> ops;
+    // External data files mapped once and shared by the tensors stored in them
+    std::unordered_map<std::string, mapped_file> external_data_files;
 
     onnx_parser();
     operation load(const std::string& name, const node_info& info) const;
@@ -112,6 +115,7 @@ struct onnx_parser
     static int64_t get_opset_version(const onnx::ModelProto& model);
 
     void parse_from(std::istream& is, std::string name = "");
+    void parse_from(const std::string& name);
     void parse_from(const void* data, std::size_t size);
     std::vector<instruction_ref>
     parse_graph(module* mod, const onnx::GraphProto& graph, bool inlining = false);
@@ -120,6 +124,10 @@ struct onnx_parser
     shape parse_type(const onnx::TypeProto& t, const std::vector<std::size_t>& input_dims) const;
 };
 
+/// Reads the model without copying the raw data of the initializers, which
+/// instead refer to their offset in the file named by location
+onnx::ModelProto read_model(const char* data, std::size_t size, const std::string& location);
+
 shape::type_t get_type(int dtype);
 bool is_type_float(shape::type_t dtype);
 
@@ -92,8 +92,7 @@ program parse_onnx_from(const onnx_options& options, Ts&&... xs)
 
 program parse_onnx(const std::string& name, const onnx_options& options)
 {
-    std::fstream input(name.c_str(), std::ios::in | std::ios::binary);
-    return parse_onnx_from(options, input, name);
+    return parse_onnx_from(options, name);
 }
 
 program parse_onnx_buffer(const std::string& buffer, const onnx_options& options)
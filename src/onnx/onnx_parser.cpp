@@ -32,9 +32,11 @@
 #include <migraphx/type_traits.hpp>
 #include <migraphx/float_equal.hpp>
 #include <migraphx/file_buffer.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/filesystem.hpp>
 #include <migraphx/op/unknown.hpp>
 #include <migraphx/env.hpp>
+#include <fstream>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -229,6 +231,35 @@ void onnx_parser::parse_from(std::istream& is, std::string name)
     }
 }
 
+void onnx_parser::parse_from(const std::string& name)
+{
+    auto file = map_file(name);
+    if(file.data == nullptr)
+    {
+        std::fstream input(name.c_str(), std::ios::in | std::ios::binary);
+        this->parse_from(input, name);
+        return;
+    }
+    auto* mm         = prog.get_main_module();
+    this->filename   = name;
+    auto parent_path = fs::path(this->filename).parent_path();
+    if(not parent_path.empty())
+        this->path = parent_path;
+
+    // The initializers are loaded from the mapped file as external data, so
+    // their payloads are never held by the protobuf messages
+    auto location = fs::path(this->filename).filename().string();
+    external_data_files[path + "/" + location] = file;
+    auto model    = read_model(file.data.get(), file.size, location);
+    auto version  = get_opset_version(model);
+    opset_version = (version == -1) ? opset_version : version;
+
+    if(model.has_graph())
+    {
+        (void)this->parse_graph(mm, model.graph());
+    }
+}
+
 void onnx_parser::parse_from(const void* data, std::size_t size)
 {
     auto* mm = prog.get_main_module();
@@ -269,9 +300,20 @@ onnx_parser::parse_graph(module* mod, const onnx::GraphProto& graph, bool inlini
 {
     std::unordered_map<std::string, instruction_ref> mod_insts;
     for(auto&& f : graph.initializer())
+    {
+        if(f.external_data().empty())
+            continue;
+        auto filename = path + "/" + f.external_data().at(0).value();
+        if(not contains(external_data_files, filename))
+            external_data_files[filename] = map_file(filename);
+    }
+    // Initializers are independent, so decode them in parallel
+    std::vector<literal> literals(graph.initializer_size());
+    par_for(literals.size(), 1, [&](auto i) { literals[i] = parse_tensor(graph.initializer(i)); });
+    for(std::size_t i = 0; i < literals.size(); i++)
     {
         // backup instructions in parent mod
-        mod_insts[f.name()] = mod->add_literal(parse_tensor(f));
+        mod_insts[graph.initializer(i).name()] = mod->add_literal(std::move(literals[i]));
     }
 
     for(auto&& input : graph.input())
@@ -411,7 +453,7 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     std::vector<std::size_t> dims(t.dims().begin(), t.dims().end());
     auto type = get_type(t.data_type());
     shape tensor_shape(type, dims);
-    auto external_data = t.external_data();
+    const auto& external_data = t.external_data();
     if(not external_data.empty())
     {
         const std::string& data_file = external_data.at(0).value();
@@ -427,9 +469,23 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
         {
             nbytes = std::stoul(t.external_data().at(2).value());
         }
-        auto raw_buffer = read_buffer(path + "/" + data_file, offset, nbytes);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
-        return create_literal(type, dims, s.data());
+        auto filename = path + "/" + data_file;
+        auto it       = external_data_files.find(filename);
+        auto file     = it == external_data_files.end() ? map_file(filename) : it->second;
+        if(file.data == nullptr)
+        {
+            auto raw_buffer = read_buffer(filename, offset, nbytes);
+            return create_literal(type, dims, raw_buffer.data());
+        }
+        if(offset > file.size or nbytes > file.size - offset or tensor_shape.bytes() > nbytes)
+            MIGRAPHX_THROW("PARSE_TENSOR: Invalid external data range in " + data_file);
+        const char* data = file.data.get() + offset;
+        // Reference the mapped pages directly when they are suitably aligned
+        if(not dims.empty() and tensor_shape.elements() > 0 and
+           reinterpret_cast<std::uintptr_t>(data) % tensor_shape.type_size() == 0)
+            return literal{tensor_shape,
+                           std::shared_ptr<char>(file.data, file.data.get() + offset)};
+        return create_literal(type, dims, data);
     }
     if(t.has_raw_data())
     {
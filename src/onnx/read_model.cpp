@@ -0,0 +1,196 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/onnx/onnx_parser.hpp>
+#include <migraphx/errors.hpp>
+#include <string>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace onnx {
+
+// Field numbers from onnx.proto
+enum
+{
+    model_graph_field       = 7,
+    graph_initializer_field = 5,
+    tensor_raw_data_field   = 9
+};
+
+enum
+{
+    wire_varint  = 0,
+    wire_fixed64 = 1,
+    wire_bytes   = 2,
+    wire_fixed32 = 5
+};
+
+// Walks the fields of a serialized message. Offsets are kept as size_t so
+// messages larger than the 2 GB limit of the protobuf parser can be read.
+struct field_reader
+{
+    struct field
+    {
+        std::uint64_t number = 0;
+        std::uint64_t wire   = 0;
+        // Start of the field's tag
+        std::size_t start = 0;
+        // Start of the payload of a length delimited field
+        std::size_t payload = 0;
+        std::size_t end     = 0;
+    };
+
+    const char* data = nullptr;
+    std::size_t size = 0;
+    std::size_t pos  = 0;
+
+    bool done() const { return pos >= size; }
+
+    std::uint64_t read_varint()
+    {
+        std::uint64_t result = 0;
+        for(std::size_t shift = 0; shift < 64 and pos < size; shift += 7)
+        {
+            auto b = static_cast<std::uint8_t>(data[pos++]);
+            result |= static_cast<std::uint64_t>(b & 0x7fu) << shift;
+            if((b & 0x80u) == 0)
+                return result;
+        }
+        MIGRAPHX_THROW("READ_MODEL: Invalid varint");
+    }
+
+    void skip(std::size_t n)
+    {
+        if(n > size - pos)
+            MIGRAPHX_THROW("READ_MODEL: Field is outside of the message");
+        pos += n;
+    }
+
+    field next()
+    {
+        field f;
+        f.start  = pos;
+        auto tag = read_varint();
+        f.number = tag >> 3u;
+        f.wire   = tag & 7u;
+        switch(f.wire)
+        {
+        case wire_varint: read_varint(); break;
+        case wire_fixed64: skip(8); break;
+        case wire_fixed32: skip(4); break;
+        case wire_bytes: {
+            auto n    = read_varint();
+            f.payload = pos;
+            skip(n);
+            break;
+        }
+        default: MIGRAPHX_THROW("READ_MODEL: Unsupported wire type " + std::to_string(f.wire));
+        }
+        f.end = pos;
+        return f;
+    }
+};
+
+// Calls f for the fields with the given number and collects the other fields,
+// which can then be parsed as a regular message
+template <class F>
+static std::string split_fields(const char* data, std::size_t size, std::uint64_t number, F f)
+{
+    std::string rest;
+    field_reader r{data, size};
+    while(not r.done())
+    {
+        auto fld = r.next();
+        if(fld.number == number and fld.wire == wire_bytes)
+            f(fld);
+        else
+            rest.append(data + fld.start, fld.end - fld.start);
+    }
+    return rest;
+}
+
+template <class Message>
+static void parse_message(Message& m, const std::string& s)
+{
+    if(not m.MergeFromString(s))
+        MIGRAPHX_THROW("READ_MODEL: Failed parsing " + m.GetTypeName());
+}
+
+// The raw data of the tensor is replaced with a reference to its location in
+// the file, so it is read through the external data path
+static onnx::TensorProto read_tensor(const char* data,
+                                     std::size_t size,
+                                     std::size_t offset,
+                                     const std::string& location)
+{
+    onnx::TensorProto t;
+    auto rest = split_fields(data, size, tensor_raw_data_field, [&](const auto& fld) {
+        t.clear_external_data();
+        auto add = [&](const std::string& key, const std::string& value) {
+            auto* entry = t.add_external_data();
+            entry->set_key(key);
+            entry->set_value(value);
+        };
+        add("location", location);
+        add("offset", std::to_string(offset + fld.payload));
+        add("length", std::to_string(fld.end - fld.payload));
+    });
+    bool has_raw_data = t.external_data_size() > 0;
+    parse_message(t, rest);
+    if(has_raw_data)
+        t.set_data_location(onnx::TensorProto::EXTERNAL);
+    return t;
+}
+
+static onnx::GraphProto
+read_graph(const char* data, std::size_t size, std::size_t offset, const std::string& location)
+{
+    onnx::GraphProto graph;
+    std::vector<onnx::TensorProto> initializers;
+    auto rest = split_fields(data, size, graph_initializer_field, [&](const auto& fld) {
+        initializers.push_back(read_tensor(
+            data + fld.payload, fld.end - fld.payload, offset + fld.payload, location));
+    });
+    parse_message(graph, rest);
+    for(auto& t : initializers)
+        *graph.add_initializer() = std::move(t);
+    return graph;
+}
+
+onnx::ModelProto read_model(const char* data, std::size_t size, const std::string& location)
+{
+    onnx::ModelProto model;
+    std::vector<onnx::GraphProto> graphs;
+    auto rest = split_fields(data, size, model_graph_field, [&](const auto& fld) {
+        graphs.push_back(
+            read_graph(data + fld.payload, fld.end - fld.payload, fld.payload, location));
+    });
+    parse_message(model, rest);
+    for(const auto& graph : graphs)
+        model.mutable_graph()->MergeFrom(graph);
+    return model;
+}
+
+} // namespace onnx
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -23,6 +23,7 @@
  */
 #include <migraphx/program.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/pass_telemetry.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
 #include <migraphx/target.hpp>
@@ -41,6 +42,13 @@ inline namespace MIGRAPHX_INLINE_NS {
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_PASSES);
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TIME_PASSES);
 
+pass enable_pass(bool enabled, pass p)
+{
+    if(enabled)
+        return p;
+    return id_pass{};
+}
+
 void validate_pass(module& mod, const pass& p, tracer trace)
 {
     (void)mod;
@@ -96,7 +104,13 @@ struct module_pm : module_pass_manager
     {
         assert(mod);
         assert(mod->validate() == mod->end());
-        if(enabled(MIGRAPHX_TIME_PASSES{}))
+        if(auto* telemetry = pass_telemetry::current())
+        {
+            const auto& r = telemetry->record(p.name(), *mod, [&] { p.apply(*this); });
+            if(enabled(MIGRAPHX_TIME_PASSES{}))
+                std::cout << p.name() << ": " << r.time << "ms\n";
+        }
+        else if(enabled(MIGRAPHX_TIME_PASSES{}))
         {
             using milliseconds = std::chrono::duration<double, std::milli>;
             auto ms            = time<milliseconds>([&] { p.apply(*this); });
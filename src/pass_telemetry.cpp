@@ -0,0 +1,96 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pass_telemetry.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/time.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// NOLINTNEXTLINE
+static thread_local pass_telemetry* current_telemetry = nullptr;
+
+pass_telemetry::pass_telemetry() : previous(current_telemetry) { current_telemetry = this; }
+
+pass_telemetry::~pass_telemetry() { current_telemetry = previous; }
+
+pass_telemetry* pass_telemetry::current() { return current_telemetry; }
+
+const pass_record& pass_telemetry::record(const std::string& pass,
+                                          const module& m,
+                                          const std::function<void()>& f)
+{
+    // Passes can run other passes, so the records are added before they
+    // run and referred to by index
+    auto index = recs.size();
+    recs.push_back({pass, m.name(), 0, m.size(), 0, {}});
+    auto parent = active;
+    active      = index;
+
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    try
+    {
+        recs[index].time = time<milliseconds>(f);
+    }
+    catch(...)
+    {
+        active = parent;
+        throw;
+    }
+    active                         = parent;
+    recs[index].instructions_after = m.size();
+    return recs[index];
+}
+
+void pass_telemetry::add_matcher_hits(const std::string& matcher, std::size_t n)
+{
+    if(active >= recs.size() or n == 0)
+        return;
+    recs[active].matcher_hits[matcher] += n;
+}
+
+const std::vector<pass_record>& pass_telemetry::records() const { return recs; }
+
+value pass_records_to_value(const std::vector<pass_record>& records)
+{
+    value result = value::array{};
+    for(const auto& r : records)
+    {
+        value hits = value::object{};
+        for(const auto& p : r.matcher_hits)
+            hits[p.first] = p.second;
+        value v                  = value::object{};
+        v["pass"]                = r.pass;
+        v["module"]              = r.module;
+        v["time_ms"]             = r.time;
+        v["instructions_before"] = r.instructions_before;
+        v["instructions_after"]  = r.instructions_after;
+        v["matcher_hits"]        = hits;
+        result.push_back(v);
+    }
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
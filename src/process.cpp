@@ -95,9 +95,11 @@ process& process::cwd(const fs::path& p)
     return *this;
 }
 
-void process::exec()
+void process::exec() { this->exec(std::cout); }
+
+void process::exec(std::ostream& os)
 {
-    auto ec = migraphx::exec(impl->get_command(), redirect_to(std::cout));
+    auto ec = migraphx::exec(impl->get_command(), redirect_to(os));
     if(ec != 0)
         MIGRAPHX_THROW("Command " + impl->get_command() + " exited with status " +
                        std::to_string(ec));
@@ -0,0 +1,314 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/profile.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <ostream>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+double instruction_profile::gbytes_per_second() const
+{
+    if(time <= 0)
+        return 0;
+    return (bytes_read + bytes_written) / (time * 1.0e6);
+}
+
+double instruction_profile::gflops_per_second() const
+{
+    if(time <= 0)
+        return 0;
+    return flops / (time * 1.0e6);
+}
+
+std::pair<std::size_t, std::size_t> estimate_bytes(instruction_ref ins)
+{
+    const auto& name = ins->name();
+    if(name.front() == '@' or contains(name, "allocate") or ins->get_shape().dynamic())
+        return {0, 0};
+    auto inputs = to_shapes(ins->inputs());
+    if(std::any_of(inputs.begin(), inputs.end(), [](const auto& s) { return s.dynamic(); }))
+        return {0, 0};
+    std::size_t bytes_written = ins->get_shape().bytes();
+    // The shape of an operator with modules can only be computed with them,
+    // so its bytes are counted here the way operation::bytes does by default
+    if(not ins->module_inputs().empty())
+    {
+        auto alias = ins->get_operator().output_alias(inputs);
+        std::size_t bytes_read = 0;
+        for(std::size_t i = 0; i < inputs.size(); i++)
+        {
+            // The aliased input is the buffer the output is written to
+            if(static_cast<std::ptrdiff_t>(i) != alias)
+                bytes_read += inputs[i].bytes();
+        }
+        return {bytes_read, bytes_written};
+    }
+    // The operator reports the bytes it moves, which are split as if the
+    // whole output is written. Views report none.
+    auto total    = ins->get_operator().bytes(inputs);
+    bytes_written = std::min(bytes_written, total);
+    return {total - bytes_written, bytes_written};
+}
+
+std::size_t estimate_flops(instruction_ref ins)
+{
+    const auto& output = ins->get_shape();
+    if(ins->name().front() == '@' or output.dynamic())
+        return 0;
+    // The pointwise module is only known by the instruction
+    if(ins->name() == "pointwise" and not ins->module_inputs().empty())
+    {
+        const auto* pm = ins->module_inputs().front();
+        auto n = std::count_if(pm->begin(), pm->end(), [](const auto& x) {
+            return x.name().front() != '@';
+        });
+        return output.elements() * n;
+    }
+    return ins->get_operator().flops(to_shapes(ins->inputs()));
+}
+
+double operation_cost::arithmetic_intensity() const
+{
+    if(bytes == 0)
+        return 0;
+    return double(flops) / bytes;
+}
+
+void print_cost_model(std::ostream& os, const std::vector<operation_cost>& costs)
+{
+    operation_cost total;
+    for(const auto& c : costs)
+    {
+        os << c.group << ": " << c.instructions << " instructions, " << c.flops << " flops, "
+           << c.bytes << " bytes, " << c.arithmetic_intensity() << " flops/byte" << std::endl;
+        total.instructions += c.instructions;
+        total.flops += c.flops;
+        total.bytes += c.bytes;
+    }
+    os << "Total: " << total.instructions << " instructions, " << total.flops << " flops, "
+       << total.bytes << " bytes, " << total.arithmetic_intensity() << " flops/byte" << std::endl;
+}
+
+#ifdef __linux__
+static int open_counter(int tid, std::uint32_t type, std::uint64_t config, int group)
+{
+    perf_event_attr attr{};
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = group == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, group, 0));
+}
+
+// Threads of the process, with the calling thread first
+static std::vector<int> process_threads()
+{
+    auto self = static_cast<int>(syscall(SYS_gettid));
+    std::vector<int> result = {self};
+    std::error_code ec;
+    for(fs::directory_iterator it{"/proc/self/task", ec}, last; not ec and it != last;
+        it.increment(ec))
+    {
+        auto tid = std::atoi(it->path().filename().string().c_str());
+        if(tid > 0 and tid != self)
+            result.push_back(tid);
+    }
+    return result;
+}
+
+hardware_counters::hardware_counters()
+{
+    const std::vector<std::tuple<std::string, std::uint32_t, std::uint64_t>> events = {
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"llc_misses",
+         PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8u) |
+             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u)}};
+    // Operators run on the workers of the thread pool, so each thread of the
+    // process gets a group
+    std::vector<std::tuple<std::string, std::uint32_t, std::uint64_t>> supported;
+    for(auto tid : process_threads())
+    {
+        // The calling thread comes first and decides which events are counted
+        bool first = groups.empty();
+        std::vector<int> group;
+        for(const auto& e : first ? events : supported)
+        {
+            // The first counter leads the group, so all of them are read at once
+            int fd = open_counter(
+                tid, std::get<1>(e), std::get<2>(e), group.empty() ? -1 : group.front());
+            if(fd < 0)
+            {
+                if(first and not group.empty())
+                    continue;
+                break;
+            }
+            group.push_back(fd);
+            if(first)
+                supported.push_back(e);
+        }
+        // The thread can exit before its counters are opened
+        if(group.empty() or group.size() != supported.size())
+        {
+            for(auto fd : group)
+                close(fd);
+            if(first)
+                return;
+            continue;
+        }
+        groups.push_back(group);
+    }
+    std::transform(supported.begin(),
+                   supported.end(),
+                   std::back_inserter(names),
+                   [](const auto& e) { return std::get<0>(e); });
+}
+
+hardware_counters::~hardware_counters()
+{
+    for(const auto& group : groups)
+    {
+        for(auto fd : group)
+            close(fd);
+    }
+}
+
+void hardware_counters::start()
+{
+    for(const auto& group : groups)
+    {
+        ioctl(group.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> hardware_counters::stop()
+{
+    if(not enabled())
+        return {};
+    for(const auto& group : groups)
+        ioctl(group.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    std::vector<std::pair<std::string, std::uint64_t>> result;
+    std::transform(names.begin(), names.end(), std::back_inserter(result), [](const auto& name) {
+        return std::make_pair(name, std::uint64_t{0});
+    });
+    for(const auto& group : groups)
+    {
+        // The group is read as the number of counters followed by their values
+        std::vector<std::uint64_t> data(group.size() + 1);
+        auto size = data.size() * sizeof(std::uint64_t);
+        if(read(group.front(), data.data(), size) != static_cast<ssize_t>(size))
+            return {};
+        std::transform(result.begin(),
+                       result.end(),
+                       data.begin() + 1,
+                       result.begin(),
+                       [](auto r, auto x) { return std::make_pair(r.first, r.second + x); });
+    }
+    return result;
+}
+#else
+hardware_counters::hardware_counters() {}
+hardware_counters::~hardware_counters() {}
+void hardware_counters::start() {}
+std::vector<std::pair<std::string, std::uint64_t>> hardware_counters::stop() { return {}; }
+#endif
+
+bool hardware_counters::enabled() const { return not groups.empty(); }
+
+static value profile_args(const instruction_profile& p)
+{
+    value result = value::object{};
+    result["bytes_read"]        = static_cast<std::uint64_t>(p.bytes_read);
+    result["bytes_written"]     = static_cast<std::uint64_t>(p.bytes_written);
+    result["flops"]             = static_cast<std::uint64_t>(p.flops);
+    result["gbytes_per_second"] = p.gbytes_per_second();
+    result["gflops_per_second"] = p.gflops_per_second();
+    for(const auto& [name, x] : p.counters)
+        result[name] = x;
+    return result;
+}
+
+value profile_to_value(const std::vector<instruction_profile>& profiles)
+{
+    value result = value::array{};
+    for(const auto& p : profiles)
+    {
+        auto v           = profile_args(p);
+        v["instruction"] = p.text;
+        v["name"]        = p.ins->name();
+        v["group"]       = p.group;
+        v["time_ms"]     = p.time;
+        result.push_back(v);
+    }
+    return result;
+}
+
+value profile_to_chrome_trace(const std::vector<instruction_profile>& profiles)
+{
+    value events = value::array{};
+    // Times of the trace are in microseconds
+    double start = 0;
+    for(const auto& p : profiles)
+    {
+        auto args           = profile_args(p);
+        args["instruction"] = p.text;
+        value event         = value::object{};
+        event["name"]       = p.ins->name();
+        event["cat"]        = p.group;
+        event["ph"]         = "X";
+        event["ts"]         = start;
+        event["dur"]        = p.time * 1000.0;
+        event["pid"]        = 0;
+        event["tid"]        = 0;
+        event["args"]       = args;
+        events.push_back(event);
+        start += p.time * 1000.0;
+    }
+    value result            = value::object{};
+    result["traceEvents"]     = events;
+    result["displayTimeUnit"] = "ms";
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -30,6 +30,7 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/time.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/program_cache.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/iterator.hpp>
@@ -41,6 +42,9 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
 #include <set>
 #include <utility>
 
@@ -53,14 +57,144 @@ inline namespace MIGRAPHX_INLINE_NS {
 
 using milliseconds = std::chrono::duration<double, std::milli>;
 
+// A single precompiled step of the main module. The inputs are indices into
+// the results of the previous steps.
+struct eval_step
+{
+    enum class kind
+    {
+        literal,
+        param,
+        outline,
+        ret,
+        op
+    };
+    kind k = kind::op;
+    instruction_ref ins;
+    operation op;
+    std::string parameter;
+    std::vector<std::size_t> inputs;
+    // Memory preallocated by the target, which each concurrent call owns
+    bool preallocation = false;
+};
+
+// Context and preallocated memory of a call to eval that runs while another
+// call uses the context of the program
+struct eval_state
+{
+    context ctx;
+    std::unordered_map<instruction_ref, argument> preallocations;
+};
+
 struct program_impl
 {
+    program_impl() = default;
+    program_impl(const program_impl&) = delete;
+    program_impl& operator=(const program_impl&) = delete;
+    ~program_impl() { clear_states(); }
+
     // A map is used to keep references to modules of the program
     std::unordered_map<std::string, module> modules;
     context ctx;
     std::string target_name;
+    // Execution plan of the main module, built when the program is finalized
+    std::vector<eval_step> plan;
+    // Version of the main module the plan was built from
+    std::size_t plan_version = 0;
+    // Set while a call to eval uses ctx
+    std::atomic<bool> ctx_busy{false};
+    // The thread ctx belongs to, which is the first one to call eval. Calls
+    // from other threads run with states, so the outputs a call returns in
+    // the preallocated memory of ctx are only overwritten by the next call
+    // from the same thread.
+    std::atomic<std::thread::id> owner{};
+    // States kept for the next concurrent calls. A call takes a state by
+    // exchanging its slot with null, so no lock is needed.
+    std::array<std::atomic<eval_state*>, 16> states{};
+
+    std::unique_ptr<eval_state> take_state()
+    {
+        for(auto& slot : states)
+        {
+            auto* state = slot.exchange(nullptr);
+            if(state != nullptr)
+                return std::unique_ptr<eval_state>{state};
+        }
+        return nullptr;
+    }
+
+    void put_state(std::unique_ptr<eval_state> state)
+    {
+        for(auto& slot : states)
+        {
+            eval_state* empty = nullptr;
+            if(slot.compare_exchange_strong(empty, state.get()))
+            {
+                state.release();
+                return;
+            }
+        }
+        // Every slot is used, so the state is freed
+    }
+
+    // The states refer to the instructions and context of the program, so they
+    // are cleared when the program is compiled or modified
+    void clear_states()
+    {
+        for(auto& slot : states)
+            delete slot.exchange(nullptr);
+        owner = std::thread::id{};
+    }
 };
 
+static bool is_preallocation(instruction_ref ins)
+{
+    return ins->name().front() != '@' and ins->inputs().empty() and
+           ins->get_operator().get_lifetime() == lifetime::global;
+}
+
+static std::vector<eval_step> make_eval_plan(const module& m)
+{
+    std::vector<eval_step> steps;
+    steps.reserve(m.size());
+    std::unordered_map<instruction_ref, std::size_t> slots;
+    for(auto ins : iterator_for(m))
+    {
+        eval_step step;
+        step.ins         = ins;
+        const auto& name = ins->name();
+        if(name == "@literal")
+        {
+            step.k = eval_step::kind::literal;
+        }
+        else if(name == "@param")
+        {
+            step.k         = eval_step::kind::param;
+            step.parameter = any_cast<builtin::param>(ins->get_operator()).parameter;
+        }
+        else if(name == "@outline")
+        {
+            step.k = eval_step::kind::outline;
+        }
+        else
+        {
+            step.k             = name == "@return" ? eval_step::kind::ret : eval_step::kind::op;
+            step.op            = ins->normalized_operator();
+            step.preallocation = is_preallocation(ins);
+        }
+        for(auto input : ins->inputs())
+        {
+            // Inputs from outside the module can't be resolved to a slot
+            if(not contains(slots, input))
+                return {};
+            step.inputs.push_back(slots.at(input));
+        }
+        slots[ins] = steps.size();
+        steps.push_back(std::move(step));
+    }
+    return steps;
+}
+
 program::program() : impl(std::make_unique<program_impl>()) { this->create_module("main"); }
 
 program::program(program&&) noexcept = default;
@@ -90,6 +224,8 @@ void program::assign(const program& p)
     impl->ctx         = p.impl->ctx;
     impl->target_name = p.impl->target_name;
     impl->modules     = p.impl->modules;
+    impl->plan.clear();
+    impl->clear_states();
 
     // build a map from old ins to new ins
     // Build a map from old module to new module
@@ -118,6 +254,13 @@ void program::assign(const program& p)
         for(auto ins : iterator_for(mp.second))
             instruction::replace_refs(ins, ins_map, mod_map);
     }
+
+    // The plan refers to the instructions of the other program, so it is rebuilt
+    if(not p.impl->plan.empty())
+    {
+        impl->plan         = make_eval_plan(*this->get_main_module());
+        impl->plan_version = this->get_main_module()->version();
+    }
 }
 
 shape program::get_parameter_shape(std::string name) const
@@ -205,9 +348,31 @@ target_assignments program::get_target_assignments(const std::vector<target>& ta
 
 bool program::is_compiled() const { return not this->impl->target_name.empty(); }
 
+bool program::has_eval_plan() const
+{
+    const auto& plan = this->impl->plan;
+    if(plan.empty())
+        return false;
+    // The main module could have been modified after the plan was built
+    return this->impl->plan_version == this->get_main_module()->version();
+}
+
 void program::compile(const target& t, compile_options options)
 {
     assert(not this->is_compiled());
+    auto cache = options.program_cache ? get_program_cache() : program_cache{};
+    std::string key;
+    if(cache.enabled())
+    {
+        key         = program_cache_key(*this, t, options);
+        auto cached = cache.get(key);
+        if(cached and cached->impl->target_name == t.name())
+        {
+            *this = std::move(*cached);
+            return;
+        }
+    }
+    this->impl->clear_states();
     this->impl->target_name = t.name();
     this->impl->ctx         = t.get_context();
 
@@ -237,12 +402,19 @@ void program::compile(const target& t, compile_options options)
         }
         mod->finalize(this->impl->ctx);
     }
+    this->impl->plan         = make_eval_plan(*this->get_main_module());
+    this->impl->plan_version = this->get_main_module()->version();
+    if(cache.enabled())
+        cache.put(key, *this);
 }
 
 void program::finalize()
 {
     auto* mm = this->get_main_module();
     mm->finalize(this->impl->ctx);
+    this->impl->plan         = make_eval_plan(*mm);
+    this->impl->plan_version = mm->version();
+    this->impl->clear_states();
 }
 
 template <class T>
@@ -397,12 +569,191 @@ std::vector<argument> generic_eval(const program& p,
     return generic_eval(mm, ctx, params, {}, make_trace);
 }
 
+// Use the preallocated memory of the state, when there is one, instead of the
+// memory shared by the program
+template <class F>
+auto with_preallocations(const eval_state* state, F make_trace)
+{
+    return [=](auto&& mod) {
+        auto trace = make_trace(mod);
+        return [=](auto ins, auto f) {
+            if(state != nullptr)
+            {
+                auto it = state->preallocations.find(ins);
+                if(it != state->preallocations.end())
+                    return trace(ins, [&] { return it->second; });
+            }
+            return trace(ins, f);
+        };
+    };
+}
+
+static std::vector<argument> plan_eval(const std::vector<eval_step>& steps,
+                                       context& ctx,
+                                       const parameter_map& params,
+                                       const eval_state* state)
+{
+    std::vector<argument> results(steps.size());
+    std::vector<argument> values;
+    values.reserve(16);
+    auto get_inputs = [&](const eval_step& step) {
+        values.resize(step.inputs.size());
+        std::transform(step.inputs.begin(),
+                       step.inputs.end(),
+                       values.begin(),
+                       [&](std::size_t i) { return results[i]; });
+    };
+    for(std::size_t i = 0; i < steps.size(); i++)
+    {
+        const auto& step = steps[i];
+        const auto& ins  = step.ins;
+        switch(step.k)
+        {
+        case eval_step::kind::literal: results[i] = ins->get_literal().get_argument(); break;
+        case eval_step::kind::param: {
+            auto it = params.find(step.parameter);
+            if(it == params.end())
+                MIGRAPHX_THROW("Parameter not found: " + step.parameter);
+            if(not ins->get_shape().dynamic() and it->second.get_shape() != ins->get_shape())
+            {
+                MIGRAPHX_THROW("Incorrect shape {" + to_string(it->second.get_shape()) +
+                               "} for parameter: " + step.parameter +
+                               " should be: " + to_string(ins->get_shape()));
+            }
+            results[i] = it->second;
+            break;
+        }
+        case eval_step::kind::outline: results[i] = argument{ins->get_shape(), nullptr}; break;
+        case eval_step::kind::ret: get_inputs(step); return values;
+        case eval_step::kind::op: {
+            get_inputs(step);
+            const auto& mod_args = ins->module_inputs();
+            // Submodules can refer to instructions of the main module, so map the results
+            // computed so far the first time a submodule is evaluated
+            std::unordered_map<instruction_ref, argument> outer;
+            auto module_eval = [&](module_ref smod,
+                                   const std::unordered_map<std::string, argument>& inputs) {
+                if(outer.empty())
+                {
+                    for(std::size_t j = 0; j < i; j++)
+                        outer.emplace(steps[j].ins, results[j]);
+                }
+                auto ssctx = ctx;
+                return generic_eval(smod,
+                                    ssctx,
+                                    inputs,
+                                    outer,
+                                    with_preallocations(
+                                        state, always([](auto&&, auto f) { return f(); })));
+            };
+            if(step.preallocation and state != nullptr)
+                results[i] = state->preallocations.at(ins);
+            else
+                results[i] = step.op.compute(ctx, ins->get_shape(), values, mod_args, module_eval);
+            break;
+        }
+        }
+        assert(ins->get_shape().any_of_dynamic() or results[i].get_shape() == ins->get_shape());
+    }
+    if(results.empty())
+        return {argument{}};
+    return {results.back()};
+}
+
+static std::unique_ptr<eval_state> make_eval_state(const program& p, const program_impl& impl)
+{
+    auto state = std::make_unique<eval_state>();
+    // A program that is not compiled has no preallocations and no context to fork
+    if(impl.target_name.empty() or impl.ctx.type_id() == typeid(std::nullptr_t))
+    {
+        state->ctx = impl.ctx;
+        return state;
+    }
+    state->ctx = impl.ctx.fork();
+    for(const auto* mod : p.get_modules())
+    {
+        for(auto ins : iterator_for(*mod))
+        {
+            if(not is_preallocation(ins))
+                continue;
+            // Finalizing a copy of the operator allocates memory for the state
+            auto op = ins->get_operator();
+            op.finalize(state->ctx, ins->get_shape(), {});
+            state->preallocations[ins] = op.compute(state->ctx, ins->get_shape(), {});
+        }
+    }
+    return state;
+}
+
+// Outputs that refer to the preallocated memory of a state are copied, since
+// the next call to eval that takes the state, which can run on another
+// thread, writes to it. The same goes for the memory of the program when the
+// caller keeps the outputs of several calls. Outputs that refer to a literal
+// are always copied, so the caller can't change the literal.
+static void
+detach_outputs(const module& m, std::vector<argument>& outputs, bool detach_preallocations)
+{
+    if(m.begin() == m.end())
+        return;
+    auto last = std::prev(m.end());
+
+    std::vector<instruction_ref> output_ins = {last};
+    if(last->name() == "@return")
+        output_ins = last->inputs();
+    for(std::size_t i = 0; i < std::min(outputs.size(), output_ins.size()); i++)
+    {
+        if(outputs[i].empty() or outputs[i].get_shape().type() == shape::tuple_type)
+            continue;
+        auto alias = instruction::get_output_alias(output_ins[i]);
+        if(alias->name() == "@literal" or (detach_preallocations and is_preallocation(alias)))
+            outputs[i] = outputs[i].copy();
+    }
+}
+
+// Reserves the context of the program for a call to eval, or a state of its own
+// when another call is using it or the call is from another thread than the
+// one the context belongs to
+struct eval_reservation
+{
+    eval_reservation(const program& p, program_impl& pimpl) : impl(&pimpl)
+    {
+        auto id    = std::this_thread::get_id();
+        auto first = std::thread::id{};
+        bool owner = impl->owner.compare_exchange_strong(first, id) or first == id;
+        if(owner and not impl->ctx_busy.exchange(true, std::memory_order_acquire))
+            return;
+        state = impl->take_state();
+        if(state == nullptr)
+            state = make_eval_state(p, *impl);
+    }
+
+    eval_reservation(const eval_reservation&) = delete;
+    eval_reservation& operator=(const eval_reservation&) = delete;
+
+    ~eval_reservation()
+    {
+        if(state == nullptr)
+            impl->ctx_busy.store(false, std::memory_order_release);
+        else
+            impl->put_state(std::move(state));
+    }
+
+    context& get_context() const { return state == nullptr ? impl->ctx : state->ctx; }
+
+    program_impl* impl;
+    std::unique_ptr<eval_state> state = nullptr;
+};
+
 std::vector<argument> program::eval(parameter_map params, execution_environment exec_env) const
 {
-    auto& ctx = this->impl->ctx;
+    // Calls from several threads can run at once, since each one that finds the
+    // context busy uses a context and preallocated memory of its own
+    eval_reservation reservation{*this, *this->impl};
+    auto& ctx               = reservation.get_context();
+    const eval_state* state = reservation.state.get();
 #ifndef NDEBUG
     auto with_check_context = [&](auto f) {
-        return [=, &ctx](auto&&) {
+        return with_preallocations(state, [=, &ctx](auto&&) {
             auto sctx          = std::make_shared<context>(ctx);
             auto check_context = [=, &ctx](auto g) {
                 assert(is_shared(ctx, *sctx));
@@ -411,13 +762,13 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
                 return x;
             };
             return [=](auto&&... xs) { return f(xs..., check_context); };
-        };
+        });
     };
 #else
-    auto with_check_context = [](auto f) {
-        return [=](auto&&) {
+    auto with_check_context = [&](auto f) {
+        return with_preallocations(state, [=](auto&&) {
             return [=](auto&&... xs) { return f(xs..., [](auto g) { return g(); }); };
-        };
+        });
     };
 #endif
 
@@ -473,6 +824,10 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
                                return result;
                            }));
     }
+    else if(this->has_eval_plan())
+    {
+        ret = plan_eval(this->impl->plan, ctx, params, state);
+    }
     else
     {
         ret = generic_eval(*this,
@@ -488,12 +843,18 @@ std::vector<argument> program::eval(parameter_map params, execution_environment
         ctx.finish_on(exec_env.queue);
     }
 
+    detach_outputs(*this->get_main_module(), ret, state != nullptr or exec_env.detach);
     return ret;
 }
 
 const int program_file_version = 5;
 
 value program::to_value() const
+{
+    return this->to_value([](const literal& l) { return migraphx::to_value(l); });
+}
+
+value program::to_value(const std::function<value(const literal&)>& save_literal) const
 {
     value result;
     result["version"] = program_file_version;
@@ -516,7 +877,7 @@ value program::to_value() const
                 node["shape"]      = migraphx::to_value(ins->get_shape());
                 node["normalized"] = ins->is_normalized();
                 if(ins->name() == "@literal")
-                    node["literal"] = migraphx::to_value(ins->get_literal());
+                    node["literal"] = save_literal(ins->get_literal());
                 node["operator"] = ins->get_operator().to_value();
                 std::vector<std::string> inputs;
                 std::transform(ins->inputs().begin(),
@@ -554,7 +915,8 @@ value program::to_value() const
 static void mod_from_val(module_ref mod,
                          const value& v,
                          std::unordered_map<std::string, instruction_ref>& instructions,
-                         const std::unordered_map<std::string, module_ref>& map_mods)
+                         const std::unordered_map<std::string, module_ref>& map_mods,
+                         const std::function<literal(const value&)>& load_literal)
 {
     const auto& module_val = v.at(mod->name());
     for(const value& node : module_val.at("nodes"))
@@ -572,8 +934,7 @@ static void mod_from_val(module_ref mod,
         }
         else if(name == "@literal")
         {
-            output =
-                mod->insert_literal(mod->end(), migraphx::from_value<literal>(node.at("literal")));
+            output = mod->insert_literal(mod->end(), load_literal(node.at("literal")));
         }
         else
         {
@@ -598,7 +959,7 @@ static void mod_from_val(module_ref mod,
 
                 for(auto& smod : module_inputs)
                 {
-                    mod_from_val(smod, v, instructions, map_mods);
+                    mod_from_val(smod, v, instructions, map_mods, load_literal);
                 }
             }
 
@@ -621,6 +982,12 @@ static void mod_from_val(module_ref mod,
 }
 
 void program::from_value(const value& v)
+{
+    this->from_value(v, [](const value& x) { return migraphx::from_value<literal>(x); });
+}
+
+void program::from_value(const value& v,
+                         const std::function<literal(const value&)>& load_literal)
 {
     auto version = v.at("version").to<int>();
     if(version != program_file_version)
@@ -628,6 +995,7 @@ void program::from_value(const value& v)
         MIGRAPHX_THROW("Warning: Program version mismatch");
     }
 
+    this->impl->clear_states();
     this->impl->target_name = v.at("target").to<std::string>();
     if(not this->impl->target_name.empty())
     {
@@ -652,7 +1020,7 @@ void program::from_value(const value& v)
 
     std::unordered_map<std::string, instruction_ref> map_insts;
     auto* mm = get_main_module();
-    mod_from_val(mm, module_vals, map_insts, map_mods);
+    mod_from_val(mm, module_vals, map_insts, map_mods, load_literal);
 
     this->finalize();
 }
@@ -674,31 +1042,158 @@ std::string perf_group(const operation& op)
 
 void program::mark(const parameter_map& params, marker&& m)
 {
-    auto& ctx = this->impl->ctx;
     // Run once by itself
     eval(params);
+    // The context is reserved like eval does, so a concurrent call to eval
+    // does not use it at the same time
+    eval_reservation reservation{*this, *this->impl};
+    auto& ctx               = reservation.get_context();
+    const eval_state* state = reservation.state.get();
     ctx.finish();
     // Start marking
     m.mark_start(*this);
-    generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
+    generic_eval(*this, ctx, params, with_preallocations(state, always([&](auto ins, auto f) {
         argument result;
         m.mark_start(ins);
         result = f();
         m.mark_stop(ins);
         return result;
-    }));
+    })));
     m.mark_stop(*this);
 }
 
+std::vector<instruction_profile>
+program::profile(parameter_map params, std::size_t n, bool use_hardware_counters) const
+{
+    // Run once by itself
+    eval(params);
+    eval_reservation reservation{*this, *this->impl};
+    auto& ctx               = reservation.get_context();
+    const eval_state* state = reservation.state.get();
+    ctx.finish();
+    std::unique_ptr<hardware_counters> counters;
+    if(use_hardware_counters)
+        counters = std::make_unique<hardware_counters>();
+
+    std::vector<instruction_profile> profiles;
+    std::vector<std::vector<double>> times;
+    // Runs where the counters were read, for the average of the counters
+    std::vector<std::size_t> reads;
+    std::unordered_map<instruction_ref, std::size_t> index;
+    const std::size_t runs = std::max<std::size_t>(n, 1);
+    for(std::size_t i = 0; i < runs; i++)
+    {
+        generic_eval(*this, ctx, params, with_preallocations(state, always([&](auto ins, auto f) {
+            auto it = index.find(ins);
+            if(it == index.end())
+            {
+                it = index.emplace(ins, profiles.size()).first;
+                profiles.emplace_back();
+                profiles.back().ins = ins;
+                times.emplace_back();
+                times.back().reserve(runs);
+                reads.push_back(0);
+            }
+            auto& p = profiles[it->second];
+            argument result;
+            if(counters)
+                counters->start();
+            times[it->second].push_back(time<milliseconds>([&] {
+                result = f();
+                ctx.finish();
+            }));
+            if(not counters)
+                return result;
+            auto values = counters->stop();
+            // A failed read returns no counters, which must not reset the totals
+            if(values.empty())
+                return result;
+            reads[it->second]++;
+            p.counters.resize(values.size());
+            std::transform(values.begin(),
+                           values.end(),
+                           p.counters.begin(),
+                           p.counters.begin(),
+                           [&](const auto& x, const auto& total) {
+                               return std::make_pair(x.first, total.second + x.second);
+                           });
+            return result;
+        })));
+    }
+
+    std::unordered_map<instruction_ref, std::string> text;
+    std::unordered_map<instruction_ref, std::string> names;
+    this->print(names, [&](auto ins, auto ins_names) {
+        std::stringstream ss;
+        instruction::print(ss, ins, ins_names);
+        text[ins] = ss.str();
+    });
+    for(std::size_t i = 0; i < profiles.size(); i++)
+    {
+        auto& p = profiles[i];
+        std::sort(times[i].begin(), times[i].end());
+        p.time                                  = common_average(times[i]);
+        p.group                                 = perf_group(p.ins->get_operator());
+        p.text                                  = text[p.ins];
+        std::tie(p.bytes_read, p.bytes_written) = estimate_bytes(p.ins);
+        p.flops                                 = estimate_flops(p.ins);
+        for(auto& c : p.counters)
+            c.second /= reads[i];
+    }
+    return profiles;
+}
+
+static void add_module_cost(const_module_ref mod,
+                            std::unordered_map<std::string, operation_cost>& costs)
+{
+    for(auto ins : iterator_for(*mod))
+    {
+        if(ins->name().front() == '@')
+            continue;
+        auto& c = costs[perf_group(ins->get_operator())];
+        c.instructions++;
+        c.flops += estimate_flops(ins);
+        auto bytes = estimate_bytes(ins);
+        c.bytes += bytes.first + bytes.second;
+        // The module of a pointwise instruction is already counted by it
+        if(ins->name() == "pointwise")
+            continue;
+        for(const auto* smod : ins->module_inputs())
+            add_module_cost(smod, costs);
+    }
+}
+
+std::vector<operation_cost> program::cost_model() const
+{
+    std::unordered_map<std::string, operation_cost> costs;
+    add_module_cost(this->get_main_module(), costs);
+    std::vector<operation_cost> result;
+    std::transform(costs.begin(), costs.end(), std::back_inserter(result), [](auto p) {
+        p.second.group = p.first;
+        return p.second;
+    });
+    std::sort(result.begin(), result.end(), [](const auto& x, const auto& y) {
+        return std::tie(y.flops, y.bytes, x.group) < std::tie(x.flops, x.bytes, y.group);
+    });
+    return result;
+}
+
 void program::perf_report(std::ostream& os,
                           std::size_t n,
                           parameter_map params,
                           std::size_t batch) const
+{
+    auto profiles = this->profile(params, n);
+    this->perf_report(os, n, std::move(params), batch, profiles);
+}
+
+void program::perf_report(std::ostream& os,
+                          std::size_t n,
+                          parameter_map params,
+                          std::size_t batch,
+                          const std::vector<instruction_profile>& profiles) const
 {
     auto& ctx = this->impl->ctx;
-    // Run once by itself
-    eval(params);
-    ctx.finish();
     // Run and time entire program
     std::vector<double> total_vec;
     total_vec.reserve(n);
@@ -710,27 +1205,10 @@ void program::perf_report(std::ostream& os,
         }));
     }
     std::sort(total_vec.begin(), total_vec.end());
-    std::unordered_map<instruction_ref, std::vector<double>> ins_vec;
-    // Fill the map
-    generic_eval(*this, ctx, params, always([&](auto ins, auto) {
-        ins_vec[ins].reserve(n);
-        return argument{ins->get_shape(), nullptr};
-    }));
+    std::unordered_map<instruction_ref, const instruction_profile*> ins_profiles;
+    for(const auto& p : profiles)
+        ins_profiles[p.ins] = &p;
 
-    // Run and time each instruction
-    for(std::size_t i = 0; i < n; i++)
-    {
-        generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
-            argument result;
-            ins_vec[ins].push_back(time<milliseconds>([&] {
-                result = f();
-                ctx.finish();
-            }));
-            return result;
-        }));
-    }
-    for(auto&& p : ins_vec)
-        std::sort(p.second.begin(), p.second.end());
     // Run and time implicit overhead
     std::vector<double> overhead_vec;
     overhead_vec.reserve(n);
@@ -746,27 +1224,38 @@ void program::perf_report(std::ostream& os,
     double total_instruction_time = 0.0;
     std::unordered_map<std::string, double> op_times;
     std::unordered_map<std::string, std::size_t> op_n;
-    for(auto&& p : ins_vec)
+    for(const auto& p : profiles)
     {
-        double avg = common_average(p.second);
-        op_times[perf_group(p.first->get_operator())] += avg;
-        total_instruction_time += avg;
-        op_n[perf_group(p.first->get_operator())]++;
+        op_times[p.group] += p.time;
+        total_instruction_time += p.time;
+        op_n[p.group]++;
     }
     double calculate_overhead_time    = total_time - total_instruction_time;
     double calculate_overhead_percent = calculate_overhead_time * 100.0 / total_time;
 
     std::unordered_map<instruction_ref, std::string> names;
     this->print(names, [&](auto ins, auto ins_names) {
-        instruction::print(std::cout, ins, ins_names);
+        instruction::print(os, ins, ins_names);
 
         // skip return instruction
         if(ins->name() == "@return")
             return;
 
-        double avg     = common_average(ins_vec[ins]);
-        double percent = std::ceil(100.0 * avg / total_instruction_time);
-        os << ": " << avg << "ms, " << percent << "%";
+        auto it = ins_profiles.find(ins);
+        if(it == ins_profiles.end())
+        {
+            os << std::endl;
+            return;
+        }
+        const auto& p  = *it->second;
+        double percent = std::ceil(100.0 * p.time / total_instruction_time);
+        os << ": " << p.time << "ms, " << percent << "%";
+        if(p.bytes_read + p.bytes_written > 0)
+            os << ", " << p.gbytes_per_second() << "GB/s";
+        if(p.flops > 0)
+            os << ", " << p.gflops_per_second() << "GFLOP/s";
+        for(const auto& c : p.counters)
+            os << ", " << c.first << ": " << c.second;
         os << std::endl;
     });
 
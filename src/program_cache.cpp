@@ -0,0 +1,188 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program_cache.hpp>
+#include <migraphx/load_save.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/host_info.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/serialize.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+extern char** environ; // NOLINT
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_PROGRAM_CACHE_PATH)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_PROGRAM_CACHE_SIZE)
+
+static std::atomic<std::size_t>& cache_hits()
+{
+    static std::atomic<std::size_t> n{0};
+    return n;
+}
+
+static std::atomic<std::size_t>& cache_misses()
+{
+    static std::atomic<std::size_t> n{0};
+    return n;
+}
+
+// The program is stored at an aligned offset in the entry, so its literals
+// are aligned when the entry is mapped
+const std::size_t program_alignment = 64;
+
+static std::size_t program_offset(const std::string& key)
+{
+    return (key.size() + 1 + program_alignment - 1) / program_alignment * program_alignment;
+}
+
+optional<program> program_cache::get(const std::string& key) const
+{
+    auto entry = store.map(key);
+    if(entry.data == nullptr)
+    {
+        cache_misses()++;
+        return nullopt;
+    }
+    try
+    {
+        // The literals are used in place from the mapping of the entry
+        auto p = load_mapping(entry, program_offset(key));
+        cache_hits()++;
+        return p;
+    }
+    catch(const std::exception&)
+    {
+        // An entry written by a build that serializes differently is a miss
+        cache_misses()++;
+        return nullopt;
+    }
+}
+
+void program_cache::put(const std::string& key, const program& p) const
+{
+    try
+    {
+        std::vector<char> data(program_offset(key) - key.size() - 1);
+        auto buffer = save_buffer(p);
+        data.insert(data.end(), buffer.begin(), buffer.end());
+        store.put(key, data);
+    }
+    catch(const std::exception&)
+    {
+        // A cache that cant be written to should not fail the compilation
+    }
+}
+
+// The MIGRAPHX_ variables that are set, since many of them change the passes
+// or the kernels. Only the ones known to not change the compiled program
+// are left out.
+static std::string migraphx_env()
+{
+    std::vector<std::string> vars;
+    for(char** e = environ; e != nullptr and *e != nullptr; e++)
+    {
+        std::string var = *e;
+        if(not starts_with(var, "MIGRAPHX_"))
+            continue;
+        if(starts_with(var, "MIGRAPHX_PROGRAM_CACHE_") or
+           starts_with(var, "MIGRAPHX_KERNEL_CACHE_PATH=") or
+           starts_with(var, "MIGRAPHX_DISABLE_KERNEL_CACHE=") or
+           starts_with(var, "MIGRAPHX_TRACE_") or starts_with(var, "MIGRAPHX_TIME_PASSES="))
+            continue;
+        vars.push_back(var);
+    }
+    std::sort(vars.begin(), vars.end());
+    return join_strings(vars, ";");
+}
+
+// Hashes eight bytes at a time, and is the same across processes
+static std::uint64_t hash_bytes(const char* data, std::size_t n, std::uint64_t h = 0)
+{
+    const std::uint64_t m = 0x9e3779b97f4a7c15ull;
+    auto mix              = [&](std::uint64_t x) {
+        h ^= x;
+        h *= m;
+        h ^= h >> 32;
+    };
+    std::size_t i = 0;
+    for(; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t))
+    {
+        std::uint64_t x;
+        std::memcpy(&x, data + i, sizeof(x));
+        mix(x);
+    }
+    if(i < n)
+    {
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, data + i, n - i);
+        mix(tail);
+    }
+    mix(n);
+    return h;
+}
+
+std::string program_cache_key(const program& p, const target& t, const compile_options& options)
+{
+    // The literals are replaced by a digest of their data, so the program is
+    // not serialized with its data again on every compile
+    auto v = p.to_value([](const literal& l) -> value {
+        return {{"shape", migraphx::to_value(l.get_shape())},
+                {"hash", hash_bytes(l.data(), l.get_shape().bytes())}};
+    });
+    auto metadata = to_msgpack(v);
+    std::stringstream ss;
+    ss << "program:" << std::hex << std::setw(16) << std::setfill('0')
+       << hash_bytes(metadata.data(), metadata.size()) << std::dec << ":target=" << t.name()
+       << ":offload_copy=" << options.offload_copy << ":fast_math=" << options.fast_math
+       << ":exhaustive_tune=" << options.exhaustive_tune
+       << ":context=" << to_string(t.get_context().to_value()) << ":host=" << get_host_isa()
+       << ":compiler=" << get_build_compiler() << ":version=" << get_build_version()
+       << ":env=" << migraphx_env();
+    return ss.str();
+}
+
+program_cache get_program_cache()
+{
+    auto p = string_value_of(MIGRAPHX_PROGRAM_CACHE_PATH{});
+    if(p.empty())
+        return {};
+    std::size_t mb = value_of(MIGRAPHX_PROGRAM_CACHE_SIZE{}, 4096);
+    return {{p, mb * 1024 * 1024}};
+}
+
+program_cache_stats get_program_cache_stats() { return {cache_hits(), cache_misses()}; }
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -41,6 +41,11 @@
 #include <migraphx/json.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/op/common.hpp>
+#include <migraphx/thread_pool.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
 
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
@@ -234,6 +239,161 @@ migraphx::shape to_shape(const py::buffer_info& info)
     }
 }
 
+migraphx::parameter_map to_parameter_map(const py::dict& params)
+{
+    migraphx::parameter_map pm;
+    for(auto x : params)
+    {
+        std::string key      = x.first.cast<std::string>();
+        py::buffer b         = x.second.cast<py::buffer>();
+        py::buffer_info info = b.request();
+        pm[key]              = migraphx::argument(to_shape(info), info.ptr);
+    }
+    return pm;
+}
+
+std::string output_parameter_name(std::size_t i) { return "main:#output_" + std::to_string(i); }
+
+// Bind the output buffers to the output parameters of the program so the
+// results are written into them directly. Returns the buffers that could not
+// be bound, which have to be copied into after evaluation.
+std::vector<std::pair<std::size_t, migraphx::argument>>
+bind_outputs(const migraphx::program& p, migraphx::parameter_map& pm, const py::list& outputs)
+{
+    std::vector<std::pair<std::size_t, migraphx::argument>> unbound;
+    auto param_shapes = p.get_parameter_shapes();
+    for(std::size_t i = 0; i < outputs.size(); i++)
+    {
+        py::buffer b         = outputs[i].cast<py::buffer>();
+        py::buffer_info info = b.request(true);
+        migraphx::argument out(to_shape(info), info.ptr);
+        auto name = output_parameter_name(i);
+        auto it   = param_shapes.find(name);
+        if(it != param_shapes.end() and it->second == out.get_shape())
+            pm[name] = out;
+        else
+            unbound.emplace_back(i, out);
+    }
+    return unbound;
+}
+
+void copy_outputs(const std::vector<migraphx::argument>& results,
+                  const std::vector<std::pair<std::size_t, migraphx::argument>>& unbound)
+{
+    for(const auto& [i, out] : unbound)
+    {
+        if(i >= results.size())
+            MIGRAPHX_THROW("MIGRAPHX PYTHON: Program has " + std::to_string(results.size()) +
+                           " outputs but output buffer " + std::to_string(i) + " was given");
+        const auto& result = results[i];
+        if(out.get_shape().type() != result.get_shape().type() or
+           out.get_shape().lens() != result.get_shape().lens())
+            MIGRAPHX_THROW("MIGRAPHX PYTHON: Output buffer " + std::to_string(i) + " has shape " +
+                           migraphx::to_string(out.get_shape()) + " but the result has shape " +
+                           migraphx::to_string(result.get_shape()));
+        if(out.data() == result.data())
+            continue;
+        migraphx::visit_all(out, result)(
+            [&](auto output, auto input) { std::copy(input.begin(), input.end(), output.begin()); });
+    }
+}
+
+// The evaluations started by one call to run_batch. The feeds are evaluated
+// concurrently on the thread pool from a separate thread so run_batch can
+// return to python straight away.
+struct run_batch_state
+{
+    std::vector<std::promise<std::vector<migraphx::argument>>> promises;
+    std::future<void> driver;
+
+    ~run_batch_state()
+    {
+        if(driver.valid())
+            driver.wait();
+    }
+};
+
+struct run_future
+{
+    std::shared_ptr<run_batch_state> batch;
+    std::shared_future<std::vector<migraphx::argument>> result;
+    // Keeps the program and the feeds alive while the batch evaluates them.
+    // They are released after the batch has finished, with the GIL held.
+    py::object program;
+    py::object feed;
+
+    run_future(std::shared_ptr<run_batch_state> b,
+               std::shared_future<std::vector<migraphx::argument>> r,
+               py::object prog,
+               py::object f)
+        : batch(std::move(b)), result(std::move(r)), program(std::move(prog)), feed(std::move(f))
+    {
+    }
+
+    run_future(const run_future&) = delete;
+    run_future& operator=(const run_future&) = delete;
+
+    ~run_future()
+    {
+        // The last future waits for the whole batch, which must not hold the GIL
+        py::gil_scoped_release nogil;
+        batch.reset();
+    }
+
+    bool done() const
+    {
+        return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    void wait() const
+    {
+        py::gil_scoped_release nogil;
+        result.wait();
+    }
+
+    std::vector<migraphx::argument> get() const
+    {
+        wait();
+        return result.get();
+    }
+};
+
+std::vector<std::unique_ptr<run_future>> run_batch(const py::object& self, const py::list& feeds)
+{
+    auto& p    = self.cast<migraphx::program&>();
+    auto batch = std::make_shared<run_batch_state>();
+    std::vector<migraphx::parameter_map> pms;
+    std::transform(feeds.begin(), feeds.end(), std::back_inserter(pms), [](py::handle feed) {
+        return to_parameter_map(feed.cast<py::dict>());
+    });
+    batch->promises.resize(pms.size());
+    std::vector<std::unique_ptr<run_future>> futures;
+    for(std::size_t i = 0; i < pms.size(); i++)
+        futures.push_back(std::make_unique<run_future>(
+            batch, batch->promises[i].get_future().share(), self, feeds[i]));
+    // Only raw pointers are captured so the batch is never released by the driver.
+    // The program outlives the driver since every future holds a reference to it,
+    // and the last future waits for the driver before releasing it.
+    auto* state   = batch.get();
+    batch->driver = std::async(std::launch::async, [&p, state, pms = std::move(pms)] {
+        migraphx::thread_pool::get().parallel(pms.size(), [&](std::size_t i) {
+            try
+            {
+                // A pool thread runs several feeds, so outputs in the memory of
+                // the program would be overwritten by the next one
+                migraphx::execution_environment exec_env{};
+                exec_env.detach = true;
+                state->promises[i].set_value(p.eval(pms[i], exec_env));
+            }
+            catch(...)
+            {
+                state->promises[i].set_exception(std::current_exception());
+            }
+        });
+    });
+    return futures;
+}
+
 MIGRAPHX_PYBIND11_MODULE(migraphx, m)
 {
     py::class_<migraphx::shape>(m, "shape")
@@ -281,6 +441,11 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
         .def("__ne__", std::not_equal_to<migraphx::argument>{})
         .def("__repr__", [](const migraphx::argument& x) { return migraphx::to_string(x); });
 
+    py::class_<run_future>(m, "future")
+        .def("result", &run_future::get)
+        .def("done", &run_future::done)
+        .def("wait", &run_future::wait);
+
     py::class_<migraphx::target>(m, "target");
 
     py::class_<migraphx::instruction_ref>(m, "instruction_ref");
@@ -349,31 +514,35 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             "create_module",
             [](migraphx::program& p, const std::string& name) { return p.create_module(name); },
             py::arg("name"))
-        .def("run",
-             [](migraphx::program& p, py::dict params) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
-                 return p.eval(pm);
-             })
+        .def(
+            "run",
+            [](migraphx::program& p,
+               py::dict params,
+               std::optional<py::list> outputs) -> py::object {
+                auto pm = to_parameter_map(params);
+                std::vector<std::pair<std::size_t, migraphx::argument>> unbound;
+                if(outputs)
+                    unbound = bind_outputs(p, pm, *outputs);
+                std::vector<migraphx::argument> results;
+                {
+                    // Other threads can run python code while this one evaluates
+                    py::gil_scoped_release nogil;
+                    results = p.eval(pm);
+                    copy_outputs(results, unbound);
+                }
+                if(outputs)
+                    return *outputs;
+                return py::cast(results);
+            },
+            py::arg("params"),
+            py::arg("outputs") = std::nullopt)
+        .def("run_batch", &run_batch, py::arg("feeds"))
         .def("run_async",
              [](migraphx::program& p,
                 py::dict params,
                 std::uintptr_t stream,
                 std::string stream_name) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
+                 auto pm = to_parameter_map(params);
                  migraphx::execution_environment exec_env{
                      migraphx::any_ptr(reinterpret_cast<void*>(stream), stream_name), true};
                  return p.eval(pm, exec_env);
@@ -39,6 +39,11 @@
 #include <migraphx/target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/par_for.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <set>
 
 namespace migraphx {
@@ -63,11 +68,219 @@ void quantize_fp16(program& prog, const std::vector<std::string>& ins_names)
                 dead_code_elimination{}});
 }
 
+// Histogram of absolute values. Its range grows by merging pairs of bins,
+// so it can be accumulated one calibration batch at a time.
+struct abs_histogram
+{
+    static constexpr std::size_t nbins = 2048;
+    std::vector<double> counts         = std::vector<double>(nbins, 0.0);
+    double width                       = 0.0;
+
+    void grow(double max_abs)
+    {
+        if(not(max_abs > 0.0) or std::isinf(max_abs))
+            return;
+        if(width == 0.0)
+        {
+            width = max_abs / nbins;
+            return;
+        }
+        while(max_abs > width * nbins)
+        {
+            for(std::size_t i = 0; i < nbins / 2; i++)
+                counts[i] = counts[2 * i] + counts[2 * i + 1];
+            std::fill(counts.begin() + nbins / 2, counts.end(), 0.0);
+            width *= 2;
+        }
+    }
+
+    void add(const abs_histogram& h)
+    {
+        std::transform(
+            counts.begin(), counts.end(), h.counts.begin(), counts.begin(), std::plus<>{});
+    }
+
+    template <class T>
+    void add(T x)
+    {
+        if(width == 0.0)
+            return;
+        auto i = static_cast<std::size_t>(x / width);
+        counts[std::min(i, nbins - 1)] += 1;
+    }
+
+    double total() const { return std::accumulate(counts.begin(), counts.end(), 0.0); }
+
+    double percentile_threshold(double percentile) const
+    {
+        const double target = total() * percentile / 100.0;
+        double sum          = 0.0;
+        for(std::size_t i = 0; i < nbins; i++)
+        {
+            sum += counts[i];
+            if(sum >= target)
+                return (i + 1) * width;
+        }
+        return nbins * width;
+    }
+
+    // Replace empty bins with a small count taken from the others, so the KL
+    // divergence stays finite
+    static bool smooth(std::vector<double>& d)
+    {
+        const double eps    = 0.0001;
+        const auto nzeros   = std::count(d.begin(), d.end(), 0.0);
+        const auto nonzeros = d.size() - nzeros;
+        if(nonzeros == 0)
+            return false;
+        const double eps1 = eps * nzeros / nonzeros;
+        std::transform(d.begin(), d.end(), d.begin(), [&](auto x) {
+            return x == 0.0 ? eps : x - eps1;
+        });
+        return true;
+    }
+
+    static double kl_divergence(const std::vector<double>& p, const std::vector<double>& q)
+    {
+        const double psum = std::accumulate(p.begin(), p.end(), 0.0);
+        const double qsum = std::accumulate(q.begin(), q.end(), 0.0);
+        return std::inner_product(
+            p.begin(), p.end(), q.begin(), 0.0, std::plus<>{}, [&](double x, double y) {
+                x /= psum;
+                y /= qsum;
+                return x * std::log(x / y);
+            });
+    }
+
+    // Divergence from the distribution clipped to the first n bins to its
+    // quantization into the int8 levels
+    double clipped_divergence(std::size_t n) const
+    {
+        const std::size_t nlevels = 128;
+        std::vector<double> p(counts.begin(), counts.begin() + n);
+        p.back() += std::accumulate(counts.begin() + n, counts.end(), 0.0);
+
+        const std::size_t merged = n / nlevels;
+        std::vector<double> q(n, 0.0);
+        for(std::size_t j = 0; j < nlevels; j++)
+        {
+            auto start = j * merged;
+            auto stop  = (j == nlevels - 1) ? n : start + merged;
+            auto level = std::accumulate(counts.begin() + start, counts.begin() + stop, 0.0);
+            auto used  = std::count_if(p.begin() + start, p.begin() + stop, [](auto x) {
+                return x != 0.0;
+            });
+            if(used == 0)
+                continue;
+            for(auto k = start; k < stop; k++)
+                q[k] = p[k] == 0.0 ? 0.0 : level / used;
+        }
+        if(not smooth(p) or not smooth(q))
+            return std::numeric_limits<double>::max();
+        return kl_divergence(p, q);
+    }
+
+    double entropy_threshold() const
+    {
+        const std::size_t first = 128;
+        std::vector<double> divergence(nbins + 1 - first);
+        par_for(divergence.size(), 1, [&](auto i) {
+            divergence[i] = this->clipped_divergence(first + i);
+        });
+        auto best = std::min_element(divergence.begin(), divergence.end()) - divergence.begin();
+        return (first + best) * width;
+    }
+};
+
+// Statistics of an instruction's input captured over the calibration data
+struct calibration_data
+{
+    std::size_t batches = 0;
+    double max_abs      = 0.0;
+    abs_histogram histogram;
+
+    template <class View>
+    void add(View x, int8_calibration calibration)
+    {
+        // Process large tensors in parallel, one chunk at a time
+        const std::size_t chunk   = 1 << 16;
+        const std::size_t nchunks = (x.size() + chunk - 1) / chunk;
+        auto for_each_chunk       = [&](auto f) {
+            par_for(nchunks, 1, [&](auto c, auto tid) {
+                auto start = c * chunk;
+                auto stop  = std::min(x.size(), start + chunk);
+                for(auto i = start; i < stop; i++)
+                    f(std::fabs(static_cast<double>(x[i])), tid);
+            });
+        };
+        const std::size_t nthreads = thread_pool::get().size();
+
+        std::vector<double> maxes(nthreads, 0.0);
+        std::vector<double> finite_maxes(nthreads, 0.0);
+        for_each_chunk([&](double v, std::size_t tid) {
+            maxes[tid] = std::max(maxes[tid], v);
+            if(std::isfinite(v))
+                finite_maxes[tid] = std::max(finite_maxes[tid], v);
+        });
+        max_abs = std::max(max_abs, *std::max_element(maxes.begin(), maxes.end()));
+        batches++;
+        if(calibration == int8_calibration::max)
+            return;
+
+        histogram.grow(*std::max_element(finite_maxes.begin(), finite_maxes.end()));
+        std::vector<abs_histogram> histograms(nthreads);
+        for(auto& h : histograms)
+            h.width = histogram.width;
+        for_each_chunk([&](double v, std::size_t tid) {
+            if(std::isfinite(v))
+                histograms[tid].add(v);
+        });
+        for(const auto& h : histograms)
+            histogram.add(h);
+    }
+
+    double threshold(const quantize_int8_options& options) const
+    {
+        if(histogram.width == 0.0)
+            return max_abs;
+        // The histogram's range is a power of 2 times its first range, so
+        // it can extend past the largest value
+        switch(options.calibration)
+        {
+        case int8_calibration::max: break;
+        case int8_calibration::percentile:
+            return std::min(max_abs, histogram.percentile_threshold(options.percentile));
+        case int8_calibration::entropy: return std::min(max_abs, histogram.entropy_threshold());
+        }
+        return max_abs;
+    }
+};
+
+double int8_calibration_threshold(const std::vector<argument>& batches,
+                                  const quantize_int8_options& options)
+{
+    calibration_data data;
+    for(const auto& batch : batches)
+        batch.visit([&](auto x) { data.add(x, options.calibration); });
+    return data.threshold(options);
+}
+
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
                    const std::vector<std::string>& ins_names)
 {
+    quantize_int8_options options;
+    options.ins_names = ins_names;
+    quantize_int8(prog, t, calibration, options);
+}
+
+void quantize_int8(program& prog,
+                   const target& t,
+                   const std::vector<parameter_map>& calibration,
+                   const quantize_int8_options& options)
+{
+    const auto& ins_names          = options.ins_names;
     std::set<std::string> op_names = {"convolution", "dot"};
     std::set<std::string> input_ins_names(ins_names.begin(), ins_names.end());
     if(not std::includes(
@@ -76,40 +289,19 @@ void quantize_int8(program& prog,
         MIGRAPHX_THROW("QUANTIZE_INT8: only support DOT and CONVOLUTION operation");
     }
 
-    std::shared_ptr<std::vector<std::pair<float, float>>> int8_quant_params =
-        std::make_shared<std::vector<std::pair<float, float>>>();
-    std::shared_ptr<std::vector<float>> max_abs_vals = std::make_shared<std::vector<float>>();
+    std::shared_ptr<std::vector<calibration_data>> calibration_stats =
+        std::make_shared<std::vector<calibration_data>>();
 
-    auto calc_quant_params = [int8_quant_params, max_abs_vals, &t](std::size_t ins_index,
-                                                                   std::vector<argument> args) {
-        std::pair<float, float> param_pair{64.0f, 0.0f};
-        // scale and shift is need for only int8 type, and we do not
-        // consider shift, so set shift to 0
-        std::vector<float> vec_val;
+    auto calc_quant_params = [calibration_stats, &t, method = options.calibration](
+                                 std::size_t ins_index, std::vector<argument> args) {
         argument arg = t.copy_from(args.front());
-        arg.visit([&](auto output) { vec_val.assign(output.begin(), output.end()); });
-        auto max_val                = *std::max_element(vec_val.begin(), vec_val.end());
-        auto min_val                = *std::min_element(vec_val.begin(), vec_val.end());
-        auto max_abs                = std::max(std::fabs(max_val), std::fabs(min_val));
-        max_abs_vals->at(ins_index) = std::max(max_abs_vals->at(ins_index), max_abs);
-
-        // if all values are 0, no need to do scaling
-        if(max_abs_vals->at(ins_index) == 0.0f)
-        {
-            param_pair.first = 1.0f;
-        }
-        else
-        {
-            param_pair.first = 127.0f / max_abs_vals->at(ins_index);
-        }
-        int8_quant_params->at(ins_index) = param_pair;
+        arg.visit([&](auto output) { calibration_stats->at(ins_index).add(output, method); });
     };
 
     // pass to add capture argument op
     std::size_t param_num = 0;
     run_passes(prog, {capture_arguments_pass{ins_names, calc_quant_params, &param_num}});
-    int8_quant_params->resize(param_num, std::pair<float, float>(64.0f, 0.0f));
-    max_abs_vals->resize(param_num, 0.0f);
+    calibration_stats->resize(param_num);
 
     // use the calibration data to compute the quantization scale
     auto capture_prog = prog;
@@ -135,12 +327,28 @@ void quantize_int8(program& prog,
         capture_prog.eval(m);
     }
 
+    // scale and shift is need for only int8 type, and we do not
+    // consider shift, so set shift to 0
+    std::vector<std::pair<float, float>> int8_quant_params;
+    std::transform(calibration_stats->begin(),
+                   calibration_stats->end(),
+                   std::back_inserter(int8_quant_params),
+                   [&](const calibration_data& data) {
+                       if(data.batches == 0)
+                           return std::make_pair(64.0f, 0.0f);
+                       auto threshold = static_cast<float>(data.threshold(options));
+                       // if all values are 0, no need to do scaling
+                       if(threshold == 0.0f)
+                           return std::make_pair(1.0f, 0.0f);
+                       return std::make_pair(127.0f / threshold, 0.0f);
+                   });
+
     // print the quantization parameters in only the main module
     if(enabled(MIGRAPHX_INT8_QUANTIZATION_PARAMS{}))
     {
-        for(std::size_t i = 0; i < int8_quant_params->size(); ++i)
+        for(std::size_t i = 0; i < int8_quant_params.size(); ++i)
         {
-            auto param = int8_quant_params->at(i);
+            auto param = int8_quant_params.at(i);
             std::cout << "ins_index = " << i << ", scale = " << param.first
                       << ", shift = " << param.second << std::endl;
         }
@@ -148,7 +356,7 @@ void quantize_int8(program& prog,
     }
 
     run_passes(prog,
-               {quantize_int8_pass{ins_names, *int8_quant_params},
+               {quantize_int8_pass{ins_names, int8_quant_params, options.per_channel_weights},
                 eliminate_common_subexpression{},
                 dead_code_elimination{},
                 simplify_reshapes{},
@@ -35,6 +35,9 @@
 #include <migraphx/target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <set>
 
@@ -50,6 +53,42 @@ static std::vector<shape::type_t>& get_quantizable_type()
     return quantable_types;
 }
 
+// Axis of the output channels when the instruction is the weight argument
+// of a convolution or dot, or -1 otherwise
+static int weight_channel_axis(instruction_ref ins)
+{
+    for(auto output : ins->outputs())
+    {
+        if(output->inputs().size() < 2 or output->inputs().at(1) != ins or
+           output->inputs().front() == ins)
+            continue;
+        if(output->name() == "convolution")
+            return 0;
+        if(output->name() == "dot")
+            return static_cast<int>(ins->get_shape().lens().size()) - 1;
+    }
+    return -1;
+}
+
+// Scale of each output channel of constant weights
+static std::vector<double> channel_scales(const argument& weights, std::size_t axis)
+{
+    const auto& s = weights.get_shape();
+    std::vector<double> max_abs(s.lens()[axis], 0.0);
+    weights.visit([&](auto w) {
+        shape_for_each(s, [&](const auto& idx) {
+            auto& m = max_abs[idx[axis]];
+            m       = std::max(m, std::fabs(static_cast<double>(w(idx.begin(), idx.end()))));
+        });
+    });
+    std::vector<double> scales(max_abs.size());
+    std::transform(max_abs.begin(), max_abs.end(), scales.begin(), [](auto m) {
+        // if all values are 0, no need to do scaling
+        return m == 0.0 ? 1.0 : m / 127.0;
+    });
+    return scales;
+}
+
 void quantize_int8_pass::apply(module& m) const // NOLINT
 {
     const auto& quantizable_types = get_quantizable_type();
@@ -68,11 +107,23 @@ void quantize_int8_pass::apply(module& m) const // NOLINT
         auto s     = input->get_shape();
         if(contains(quantizable_types, s.type()) and s.type() != shape::int8_type)
         {
-            auto zero_point  = m.add_literal(static_cast<int8_t>(param.second));
-            auto scale       = m.add_literal(literal({s.type()}, {1.0f / param.first}));
             const auto& lens = s.lens();
-            scale =
-                m.insert_instruction(ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            auto zero_point  = m.add_literal(static_cast<int8_t>(param.second));
+            instruction_ref scale;
+            auto axis = per_channel_weights ? weight_channel_axis(ins) : -1;
+            if(axis >= 0 and input->can_eval())
+            {
+                auto scales = channel_scales(input->eval(), axis);
+                scale       = m.add_literal(literal({s.type(), {scales.size()}}, scales));
+                scale       = m.insert_instruction(
+                    ins, make_op("broadcast", {{"axis", axis}, {"out_lens", lens}}), scale);
+            }
+            else
+            {
+                scale = m.add_literal(literal({s.type()}, {1.0f / param.first}));
+                scale = m.insert_instruction(
+                    ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            }
             zero_point = m.insert_instruction(
                 ins, make_op("multibroadcast", {{"out_lens", lens}}), zero_point);
             auto q_in =
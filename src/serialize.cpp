@@ -29,21 +29,58 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+static const raw_data_serializer_scope*& current_serializer()
+{
+    static thread_local const raw_data_serializer_scope* s = nullptr;
+    return s;
+}
+
+raw_data_serializer_scope::raw_data_serializer_scope(save_function s, load_function l)
+    : save(std::move(s)), load(std::move(l)), previous(current_serializer())
+{
+    current_serializer() = this;
+}
+
+raw_data_serializer_scope::~raw_data_serializer_scope() { current_serializer() = previous; }
+
+// The literal shares the data of the argument, which it keeps alive
+static literal share_literal(const argument& a)
+{
+    return {a.get_shape(), std::shared_ptr<char>(a.data(), [a](char*) {})};
+}
+static literal share_literal(const literal& l) { return l; }
+
 template <class RawData>
 void raw_data_to_value(value& v, const RawData& rd)
 {
     value result;
     result["shape"] = migraphx::to_value(rd.get_shape());
+    const auto* serializer = current_serializer();
     if(rd.get_shape().type() == shape::tuple_type)
         result["sub"] = migraphx::to_value(rd.get_sub_objects());
+    else if(not rd.empty() and serializer != nullptr)
+        result["external"] = serializer->save(share_literal(rd));
     else if(not rd.empty())
         result["data"] = migraphx::value::binary(rd.data(), rd.get_shape().bytes());
     v = result;
 }
 
+static literal load_external(const value& v)
+{
+    const auto* serializer = current_serializer();
+    if(serializer == nullptr)
+        MIGRAPHX_THROW("Data is stored externally, but there is nothing to load it from");
+    return serializer->load(v.at("external"));
+}
+
 void migraphx_to_value(value& v, const literal& l) { raw_data_to_value(v, l); }
 void migraphx_from_value(const value& v, literal& l)
 {
+    if(v.contains("external"))
+    {
+        l = load_external(v);
+        return;
+    }
     auto s = migraphx::from_value<shape>(v.at("shape"));
     l      = literal(s, v.at("data").get_binary().data());
 }
@@ -51,7 +88,13 @@ void migraphx_from_value(const value& v, literal& l)
 void migraphx_to_value(value& v, const argument& a) { raw_data_to_value(v, a); }
 void migraphx_from_value(const value& v, argument& a)
 {
-    if(v.contains("data"))
+    if(v.contains("external"))
+    {
+        // Share the data of the literal instead of copying it
+        auto l = load_external(v);
+        a      = argument{l.get_shape(), [l] { return const_cast<char*>(l.data()); }};
+    }
+    else if(v.contains("data"))
     {
         literal l = migraphx::from_value<literal>(v);
         a         = l.get_argument();
@@ -45,7 +45,7 @@ std::unordered_set<std::string> get_quantizable_op_names()
     return s;
 }
 
-MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
+static bool all_same_value(instruction_ref ins)
 {
     if(ins->name() != "@literal")
         return false;
@@ -58,22 +58,40 @@ MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
     return all_same;
 }
 
+MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins) { return all_same_value(ins); }
+
+// Checks the scale is a 1-D literal broadcast along the output channels of
+// the weights of a convolution or dot
+static bool is_channel_scale(instruction_ref qop, instruction_ref scale)
+{
+    auto dq       = qop->inputs().at(1);
+    auto scale_bc = dq->inputs().at(1);
+    if(scale_bc->name() != "broadcast" or scale_bc->inputs().front() != scale or
+       scale->get_shape().lens().size() != 1)
+        return false;
+    auto ndim = dq->get_shape().lens().size();
+    auto axis = qop->name() == "convolution" ? 0 : ndim - 1;
+    return scale_bc->get_operator().to_value()["axis"].to<std::size_t>() == axis;
+}
+
 struct match_find_quantizable_ops
 {
 
-    static auto dequantizelinear_op(const std::string& name, const std::string& scale)
+    template <class M>
+    static auto dequantizelinear_op(const std::string& name, M scale)
     {
         return match::name("dequantizelinear")(
             match::arg(0)(match::skip(match::name("quantizelinear"))(match::any().bind(name))),
-            match::arg(1)(match::skip_broadcasts(has_same_value().bind(scale))),
+            match::arg(1)(match::skip_broadcasts(scale)),
             match::arg(2)(match::skip_broadcasts(match::all_of(match::has_value(0)))));
     }
 
     auto matcher() const
     {
+        // The weights may be quantized with a scale for each output channel
         return match::name(get_quantizable_op_names())(
-            match::arg(0)(dequantizelinear_op("x1", "scale1")),
-            match::arg(1)(dequantizelinear_op("x2", "scale2")));
+            match::arg(0)(dequantizelinear_op("x1", has_same_value().bind("scale1"))),
+            match::arg(1)(dequantizelinear_op("x2", match::name("@literal").bind("scale2"))));
     }
 
     void apply(module& m, const match::matcher_result& r) const
@@ -89,9 +107,19 @@ struct match_find_quantizable_ops
            q2->get_shape().type() != migraphx::shape::int8_type)
             return;
 
-        double scale;
+        bool per_channel = not all_same_value(scale2);
+        if(per_channel and not is_channel_scale(qop, scale2))
+            return;
+
+        std::vector<double> scales;
         visit_all(scale1->get_literal(), scale2->get_literal())(
-            [&](const auto s1, const auto s2) { scale = s1.front() * s2.front(); });
+            [&](const auto s1, const auto s2) {
+                auto n = per_channel ? s2.size() : 1;
+                std::transform(s2.begin(),
+                               s2.begin() + n,
+                               std::back_inserter(scales),
+                               [&](auto x) { return s1.front() * x; });
+            });
 
         auto qop_args  = qop->inputs();
         qop_args.at(0) = q1;
@@ -110,12 +138,22 @@ struct match_find_quantizable_ops
             dq = m.insert_instruction(qop, migraphx::make_op("quant_dot"), qop_args);
         }
         auto ins_type = qop->get_shape().type();
-        dq_scale      = m.add_literal(literal({ins_type}, {scale}));
-
-        auto lens = dq->get_shape().lens();
-        auto scale_mb =
-            m.insert_instruction(qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
-        dq = m.insert_instruction(qop, make_op("dequantizelinear"), dq, scale_mb);
+        auto lens     = dq->get_shape().lens();
+        if(per_channel)
+        {
+            // Output channels are on axis 1 of a convolution and the last axis of a dot
+            auto axis = qop->name() == "convolution" ? 1 : lens.size() - 1;
+            dq_scale  = m.add_literal(literal({ins_type, {scales.size()}}, scales));
+            dq_scale  = m.insert_instruction(
+                qop, make_op("broadcast", {{"axis", axis}, {"out_lens", lens}}), dq_scale);
+        }
+        else
+        {
+            dq_scale = m.add_literal(literal({ins_type}, {scales.front()}));
+            dq_scale = m.insert_instruction(
+                qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
+        }
+        dq = m.insert_instruction(qop, make_op("dequantizelinear"), dq, dq_scale);
         m.replace_instruction(qop, dq);
     }
 };
@@ -799,25 +799,22 @@ struct find_transpose_slice
 
 void simplify_reshapes::apply(module& m) const
 {
-    for(int i = 0; i < 4; i++)
-    {
-        match::find_matches(m,
-                            find_where_op{},
-                            find_resize{},
-                            find_reshape_cont{},
-                            find_nop_reshapes{},
-                            find_reshaper{},
-                            find_transpose{},
-                            find_concat_transpose{},
-                            find_concat_multibroadcasts{},
-                            find_nested_convert{},
-                            find_nested_slice{},
-                            find_nested_concat{},
-                            find_transpose_slice{},
-                            find_slice_transpose{},
-                            find_transpose_contiguous_reshaper_unary{});
-        dead_code_elimination{}.apply(m);
-    }
+    match::find_matches_fixpoint(m,
+                                 find_where_op{},
+                                 find_resize{},
+                                 find_reshape_cont{},
+                                 find_nop_reshapes{},
+                                 find_reshaper{},
+                                 find_transpose{},
+                                 find_concat_transpose{},
+                                 find_concat_multibroadcasts{},
+                                 find_nested_convert{},
+                                 find_nested_slice{},
+                                 find_nested_concat{},
+                                 find_transpose_slice{},
+                                 find_slice_transpose{},
+                                 find_transpose_contiguous_reshaper_unary{});
+    dead_code_elimination{}.apply(m);
 }
 
 } // namespace MIGRAPHX_INLINE_NS
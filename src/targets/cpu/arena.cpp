@@ -0,0 +1,94 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/arena.hpp>
+#include <migraphx/make_shared_array.hpp>
+#include <algorithm>
+#include <mutex>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Keep each buffer on its own cache lines
+const std::size_t arena_alignment = 64;
+
+struct arena_state
+{
+    std::mutex m;
+    std::shared_ptr<char> block = nullptr;
+    std::size_t capacity        = 0;
+    std::size_t offset          = 0;
+    std::size_t high_water      = 0;
+    std::size_t live            = 0;
+};
+
+arena::arena() : state(std::make_shared<arena_state>()) {}
+
+std::shared_ptr<char> arena::allocate(std::size_t n)
+{
+    std::lock_guard<std::mutex> lock(state->m);
+    auto start = state->offset;
+    state->offset += (n + arena_alignment - 1) / arena_alignment * arena_alignment;
+    state->high_water = std::max(state->high_water, state->offset);
+
+    std::shared_ptr<char> buffer;
+    if(state->offset <= state->capacity)
+    {
+        buffer = std::shared_ptr<char>(state->block, state->block.get() + start);
+        std::fill(buffer.get(), buffer.get() + n, 0);
+    }
+    else
+    {
+        buffer = make_shared_array<char>(n);
+    }
+    state->live++;
+    return {buffer.get(), [s = state, buffer](char*) mutable {
+                std::lock_guard<std::mutex> release_lock(s->m);
+                buffer = nullptr;
+                s->live--;
+            }};
+}
+
+void arena::reset()
+{
+    std::lock_guard<std::mutex> lock(state->m);
+    // Buffers still in use keep the old block alive, so a new one is used
+    // instead of handing out their memory again
+    if(state->live > 0 or state->capacity < state->high_water)
+    {
+        state->capacity = std::max(state->capacity, state->high_water);
+        state->block    = make_shared_array<char>(state->capacity);
+    }
+    state->offset = 0;
+}
+
+std::size_t arena::capacity() const
+{
+    std::lock_guard<std::mutex> lock(state->m);
+    return state->capacity;
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,351 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/cpp_generator.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <migraphx/kernel_cache.hpp>
+#include <migraphx/host_info.hpp>
+#include <migraphx/process.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_DUMP_SRC)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND)
+
+using kernel_function = void(void**, std::size_t, std::size_t);
+
+static value::binary compile_pointwise_src(const std::string& src);
+
+struct cpu_code_object
+{
+    value::binary code_object{};
+    // The source is kept so the code object can be rebuilt for another host
+    std::string src         = "";
+    std::string host        = "";
+    std::string symbol_name = "";
+    std::vector<shape> expected_inputs{};
+    shape output{};
+    // Operators of the fused module, which are done for each element
+    std::size_t ops_per_element           = 0;
+    std::function<kernel_function> kernel = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.code_object, "code_object"),
+                    f(self.src, "src"),
+                    f(self.host, "host"),
+                    f(self.symbol_name, "symbol_name"),
+                    f(self.expected_inputs, "expected_inputs"),
+                    f(self.output, "output"),
+                    f(self.ops_per_element, "ops_per_element"));
+    }
+
+    std::string name() const { return "cpu::code_object"; }
+
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        if(inputs != expected_inputs)
+            MIGRAPHX_THROW("Input shapes have changed: [" + to_string_range(expected_inputs) +
+                           "] -> [" + to_string_range(inputs) + "]");
+        return output;
+    }
+
+    argument compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        assert(kernel != nullptr);
+        std::vector<void*> kargs(args.size());
+        std::transform(
+            args.begin(), args.end(), kargs.begin(), [](const argument& a) { return a.data(); });
+        ctx.bulk_execute(output_shape.elements(), 1024, [&](auto start, auto stop) {
+            kernel(kargs.data(), start, stop);
+        });
+        return args.back();
+    }
+
+    void finalize(context&, const shape&, const std::vector<shape>&)
+    {
+        // Code built with -march=native may use instructions this cpu does
+        // not have, such as for a program saved on another host
+        if(host != get_host_isa() and not src.empty())
+        {
+            code_object = compile_pointwise_src(src);
+            host        = get_host_isa();
+        }
+        assert(not code_object.empty());
+        dynamic_loader loader{reinterpret_cast<const char*>(code_object.data()),
+                              code_object.size()};
+        kernel = loader.get_function<kernel_function>(symbol_name);
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+
+    std::size_t flops(const std::vector<shape>&) const
+    {
+        return output.elements() * ops_per_element;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const cpu_code_object& op)
+    {
+        os << op.name() << "[";
+        os << "code_object=" << op.code_object.size() << ",";
+        os << "symbol_name=" << op.symbol_name;
+        os << "]";
+        return os;
+    }
+};
+MIGRAPHX_REGISTER_OP(cpu_code_object);
+
+// NOLINTNEXTLINE
+static const char* const pointwise_preamble = R"__migraphx__(
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace migraphx_cpu {
+using namespace std;
+
+template <class T>
+T rsqrt(T x)
+{
+    return T(1) / sqrt(x);
+}
+
+template <class T, class U>
+T convert(U x)
+{
+    return static_cast<T>(x);
+}
+
+template <class T, class U>
+auto where(bool cond, T x, U y)
+{
+    return cond ? x : y;
+}
+} // namespace migraphx_cpu
+
+)__migraphx__";
+
+static bool is_host_type(shape::type_t t)
+{
+    return not contains({shape::half_type, shape::tuple_type}, t);
+}
+
+static bool is_point_op(instruction_ref ins)
+{
+    if(not is_host_type(ins->get_shape().type()))
+        return false;
+    if(contains({"@param", "@return"}, ins->name()))
+        return true;
+    if(ins->name() == "@literal")
+        return ins->get_shape().elements() == 1;
+    auto attributes = ins->get_operator().attributes();
+    return attributes.contains("point_op") and
+           not attributes["point_op"].to<std::string>().empty();
+}
+
+// Only packed outputs where the inputs share the same layout (or are a single
+// element) can be computed with a flat loop over the buffers
+static bool is_compilable(instruction_ref ins)
+{
+    auto s = ins->get_shape();
+    if(s.dynamic() or not s.packed() or not is_host_type(s.type()))
+        return false;
+    if(not all_of(ins->inputs(), [&](auto input) {
+           const auto& is = input->get_shape();
+           if(not is_host_type(is.type()))
+               return false;
+           return is.elements() == 1 or (is.lens() == s.lens() and is.strides() == s.strides());
+       }))
+        return false;
+    return all_of(iterator_for(*ins->module_inputs().front()), &is_point_op);
+}
+
+static std::string generate_pointwise_src(const module& pm,
+                                          const std::vector<shape>& inputs,
+                                          const shape& output,
+                                          const std::string& kernel_name)
+{
+    cpp_generator g;
+    g.fmap([](const std::string& fname) { return "migraphx_cpu::" + fname; });
+    g.fresult([](const shape& s) { return shape::cpp_type(s.type()); });
+    auto fname = g.create_function(
+        g.generate_module(pm).set_name("pointwise_op").set_attributes({"static", "inline"}));
+
+    std::stringstream ss;
+    ss << pointwise_preamble << g.str() << "\n";
+    ss << "extern \"C\" void " << kernel_name
+       << "(void** args, std::size_t start, std::size_t stop)\n{\n";
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        ss << "    const auto* p" << i << " = reinterpret_cast<const "
+           << shape::cpp_type(inputs[i].type()) << "*>(args[" << i << "]);\n";
+    }
+    ss << "    auto* y = reinterpret_cast<" << shape::cpp_type(output.type()) << "*>(args["
+       << inputs.size() << "]);\n";
+    std::vector<std::string> args;
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        // Single elements are broadcasted across the whole output
+        bool broadcasted = inputs[i].elements() == 1 and output.elements() != 1;
+        args.push_back("p" + std::to_string(i) + (broadcasted ? "[0]" : "[i]"));
+    }
+    ss << "#pragma omp simd\n";
+    ss << "    for(std::size_t i = start; i < stop; i++)\n";
+    ss << "        y[i] = " << fname << "(" << join_strings(args, ", ") << ");\n";
+    ss << "}\n";
+    return ss.str();
+}
+
+// The compiler version and the cpu and features that -march=native resolves
+// to on this host, taken from the commands the compiler driver would run
+static std::string compiler_host_info()
+{
+    static const std::string result = [] {
+        std::string compiler = MIGRAPHX_STRINGIZE(MIGRAPHX_CPU_COMPILER);
+        std::stringstream ss;
+        try
+        {
+            process{compiler + " -march=native -### -E -x c++ /dev/null 2>&1"}.exec(ss);
+        }
+        catch(const std::exception&)
+        {
+            // The host cpu below still keeps the entries of other hosts apart
+        }
+        return ss.str() + "\n" + get_host_isa();
+    }();
+    return result;
+}
+
+static value::binary compile_pointwise_src(const std::string& src)
+{
+    if(enabled(MIGRAPHX_CPU_DUMP_SRC{}))
+        std::cout << src << std::endl;
+    src_compiler compiler;
+    compiler.compiler = MIGRAPHX_STRINGIZE(MIGRAPHX_CPU_COMPILER);
+    compiler.flags    = "-std=c++17 -O3 -march=native -fopenmp-simd -fPIC -shared";
+    compiler.output   = "libpointwise.so";
+    src_file f;
+    f.path    = "pointwise.cpp";
+    f.content = std::make_pair(src.data(), src.data() + src.size());
+    auto key  = "cpu\n" + compiler.compiler + "\n" + compiler_host_info() + "\n" +
+               compiler.flags + "\n" + src;
+    return value::binary{
+        get_kernel_cache().get_or_compile(key, [&] { return compiler.compile({f}); })};
+}
+
+// With the workaround disabled, fuse_ops merges pointwise operators into the
+// convolutions and dots they follow as dnnl post ops, which is cheaper than
+// a separate loop over the result
+static bool is_post_op(instruction_ref ins)
+{
+    if(not enabled(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND{}))
+        return false;
+    return any_of(ins->inputs(), [](auto input) {
+        return input->outputs().size() == 1 and
+               contains({"convolution", "deconvolution", "dot", "quant_convolution", "quant_dot"},
+                        input->name());
+    });
+}
+
+// Replace the pointwise instruction with the operators of its module
+static void inline_pointwise(module& m, instruction_ref ins)
+{
+    const auto* pm = ins->module_inputs().front();
+    auto names     = pm->get_parameter_names();
+    std::sort(names.begin(), names.end());
+    std::unordered_map<instruction_ref, instruction_ref> map_ins;
+    for(std::size_t i = 0; i < names.size(); i++)
+        map_ins[pm->get_parameter(names[i])] = ins->inputs().at(i);
+    // Literals were made scalars by fuse_pointwise, so broadcast them again
+    for(auto pins : iterator_for(*pm))
+    {
+        if(pins->name() != "@literal")
+            continue;
+        auto l        = m.add_literal(pins->get_literal());
+        map_ins[pins] = m.insert_instruction(
+            ins, make_op("multibroadcast", {{"out_lens", ins->get_shape().lens()}}), l);
+    }
+    auto results = m.insert_instructions(ins, pm, map_ins);
+    m.replace_instruction(ins, results.front());
+}
+
+void compile_pointwise::apply(module& m) const
+{
+    const std::string kernel_name = "pointwise_kernel";
+    // Fused modules often generate the same source, so only compile it once
+    std::unordered_map<std::string, value::binary> compiled;
+    for(auto ins : iterator_for(m))
+    {
+        if(ins->name() != "pointwise")
+            continue;
+        if(not is_compilable(ins) or is_post_op(ins))
+        {
+            inline_pointwise(m, ins);
+            continue;
+        }
+        auto inputs     = to_shapes(ins->inputs());
+        const auto* pm  = ins->module_inputs().front();
+        auto src        = generate_pointwise_src(*pm, inputs, ins->get_shape(), kernel_name);
+        std::size_t ops = std::count_if(
+            pm->begin(), pm->end(), [](const auto& x) { return x.name().front() != '@'; });
+        if(not contains(compiled, src))
+            compiled[src] = compile_pointwise_src(src);
+        auto alloc = m.insert_instruction(
+            ins, make_op("allocate", {{"shape", to_value(ins->get_shape())}}));
+        auto args = ins->inputs();
+        args.push_back(alloc);
+        inputs.push_back(ins->get_shape());
+        m.replace_instruction(
+            ins,
+            cpu_code_object{
+                compiled.at(src), src, get_host_isa(), kernel_name, inputs, ins->get_shape(), ops},
+            args);
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
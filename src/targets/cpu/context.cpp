@@ -0,0 +1,112 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <exception>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+context::context(std::size_t n) : streams(std::max<std::size_t>(n, 1))
+{
+    std::generate(streams.begin() + 1, streams.end(), [] { return std::make_shared<stream>(); });
+}
+
+void context::set_stream(std::size_t n)
+{
+    if(n >= streams.size())
+        MIGRAPHX_THROW("Invalid stream: " + std::to_string(n));
+    current_stream = n;
+}
+
+void context::enqueue(std::function<void()> f)
+{
+    if(current_stream == 0)
+        f();
+    else
+        streams[current_stream]->push(std::move(f));
+}
+
+void context::sync(std::size_t n) const
+{
+    if(n > 0)
+        streams.at(n)->sync();
+}
+
+void context::create_events(std::size_t num_of_events)
+{
+    for(std::size_t i = events.size(); i < num_of_events + 1; i++)
+        events.emplace_back(std::make_shared<event>());
+}
+
+void context::record_event(std::size_t n)
+{
+    auto e = events.at(n);
+    e->record();
+    enqueue([=] { e->complete(); });
+}
+
+void context::wait_event(std::size_t n)
+{
+    auto e      = events.at(n);
+    auto target = e->last();
+    enqueue([=] { e->wait(target); });
+}
+
+context context::fork() const
+{
+    context result{nstreams()};
+    // The events are created when the program is finalized, which is not done
+    // again for a fork
+    if(not events.empty())
+        result.create_events(events.size() - 1);
+    return result;
+}
+
+void context::finish() const
+{
+    // Every stream is drained before the first error is rethrown, so no task
+    // still uses the buffers of the evaluation
+    std::exception_ptr error;
+    for(std::size_t n = 1; n < streams.size(); n++)
+    {
+        try
+        {
+            sync(n);
+        }
+        catch(...)
+        {
+            if(not error)
+                error = std::current_exception();
+        }
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -35,8 +35,8 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
-struct dnnl_convolution
-    : dnnl_extend_op<dnnl_convolution, dnnl::convolution_forward, op::convolution>
+template <class Derived, class Op>
+struct dnnl_convolution_base : dnnl_extend_op<Derived, dnnl::convolution_forward, Op>
 {
     std::vector<int> arg_map(int) const
     {
@@ -45,15 +45,15 @@ struct dnnl_convolution
 
     shape adjust_shape(const shape& x, int i, const shape& output) const
     {
-        auto s = base_adjust_shape(x, output);
-        if(i == 1 and op.group > 1)
+        auto s = this->base_adjust_shape(x, output);
+        if(i == 1 and this->op.group > 1)
         {
             // TODO: Add support for transposed weights
             if(not s.standard())
                 MIGRAPHX_THROW("Weights for grouped convolution must be standard");
             auto lens = s.lens();
-            lens.insert(lens.begin(), op.group);
-            lens.at(1) /= op.group;
+            lens.insert(lens.begin(), this->op.group);
+            lens.at(1) /= this->op.group;
             return shape{s.type(), lens};
         }
         return s;
@@ -63,7 +63,8 @@ struct dnnl_convolution
     get_desc(const std::unordered_map<int, dnnl::memory::desc>& m) const
     {
         // In DNNL dilation is zero-based
-        auto dilation = op.dilation;
+        const auto& op = this->op;
+        auto dilation  = op.dilation;
         std::transform(
             dilation.begin(), dilation.end(), dilation.begin(), [](auto x) { return x - 1; });
         auto kdims = op.kdims();
@@ -81,6 +82,16 @@ struct dnnl_convolution
     }
 };
 
+struct dnnl_convolution : dnnl_convolution_base<dnnl_convolution, op::convolution>
+{
+};
+
+// int8 convolution accumulating in int32
+struct dnnl_quant_convolution
+    : dnnl_convolution_base<dnnl_quant_convolution, op::quant_convolution>
+{
+};
+
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
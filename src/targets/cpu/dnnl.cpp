@@ -53,6 +53,12 @@ dnnl_context& get_dnnl_context()
     return ctx;
 }
 
+dnnl::stream& get_dnnl_stream()
+{
+    thread_local dnnl::stream s{get_dnnl_context().engine}; // NOLINT
+    return s;
+}
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
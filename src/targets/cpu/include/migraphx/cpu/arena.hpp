@@ -0,0 +1,64 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_ARENA_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_ARENA_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct arena_state;
+
+/// Bump allocator for the buffers operators allocate while they compute.
+/// Buffers are handed out from a single block, which is reset at the start
+/// of every evaluation. Allocations that do not fit come from the heap, and
+/// the block grows at the next reset to the most that an evaluation used, so
+/// an evaluation that repeats allocates nothing. Copies share the same block.
+struct arena
+{
+    arena();
+
+    /// A zero-initialized buffer of n bytes
+    std::shared_ptr<char> allocate(std::size_t n);
+
+    /// Hands out buffers from the start of the block again. Buffers that are
+    /// still in use keep their memory, and the block is replaced instead.
+    void reset();
+
+    /// Size of the block buffers are handed out from
+    std::size_t capacity() const;
+
+    private:
+    std::shared_ptr<arena_state> state;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_ARENA_HPP
@@ -25,17 +25,53 @@
 #define MIGRAPHX_GUARD_RTGLIB_CONTEXT_HPP
 
 #include <migraphx/config.hpp>
+#include <migraphx/cpu/arena.hpp>
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
+#include <migraphx/cpu/stream.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/env.hpp>
+#include <memory>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_CPU_NSTREAMS)
+
+/// Stream 0 is the thread evaluating the program, the other streams each have
+/// their own worker thread which is used by the schedule pass to run
+/// independent instructions concurrently
 struct context
 {
-    void finish() const {}
+    context(std::size_t n = value_of(MIGRAPHX_CPU_NSTREAMS{}, 1));
+
+    std::size_t nstreams() const { return streams.size(); }
+
+    std::size_t stream_id() const { return current_stream; }
+
+    void set_stream(std::size_t n);
+
+    /// Run f on the current stream, or right away when it is stream 0
+    void enqueue(std::function<void()> f);
+
+    /// Wait for everything issued on stream n
+    void sync(std::size_t n) const;
+
+    void create_events(std::size_t num_of_events);
+    void record_event(std::size_t n);
+    void wait_event(std::size_t n);
+
+    /// Wait for every stream. The first exception thrown by a task on any
+    /// of them is rethrown once they have all finished.
+    void finish() const;
+
+    /// Serves the buffers allocated by operators without a cpu kernel
+    arena& get_arena() { return scratch; }
+
+    /// A context with streams and events of its own
+    context fork() const;
 
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
@@ -48,6 +84,12 @@ struct context
     {
         this->bulk_execute(n, 256, f);
     }
+
+    private:
+    std::size_t current_stream = 0;
+    std::vector<std::shared_ptr<stream>> streams;
+    std::vector<std::shared_ptr<event>> events;
+    arena scratch;
 };
 
 } // namespace cpu
@@ -30,6 +30,8 @@
 #include <migraphx/register_op.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 #include <migraphx/errors.hpp>
 #include <migraphx/assert.hpp>
 #ifdef MIGRAPHX_ENABLE_ZENDNN
@@ -53,12 +55,15 @@ namespace dnnl = zendnn;
 struct dnnl_context
 {
     dnnl::engine engine;
-    dnnl::stream stream;
-    dnnl_context() : engine(dnnl::engine::kind::cpu, 0), stream(engine) {}
+    dnnl_context() : engine(dnnl::engine::kind::cpu, 0) {}
 };
 
 dnnl_context& get_dnnl_context();
 
+// Primitives can be executed from several streams of the cpu context at
+// once, so each thread has its own dnnl stream
+dnnl::stream& get_dnnl_stream();
+
 dnnl::memory::data_type to_dnnl_memory_data_type(shape::type_t t);
 
 dnnl::memory::format_tag to_dnnl_memory_format_tag(std::size_t n);
@@ -95,12 +100,15 @@ template <class Derived, class Primitive>
 struct dnnl_op : auto_register_op<Derived>
 {
     std::vector<post_op> post_ops;
+    // The weights are constant, so they are reordered once into the layout
+    // the primitive prefers instead of being described in their plain layout
+    bool prepack_weights = false;
     std::function<argument(context& ctx, const std::vector<argument>& args)> execute;
 
     template <class Self, class F>
     static auto reflect_base(Self& self, F f)
     {
-        return pack(f(self.post_ops, "post_ops"));
+        return pack(f(self.post_ops, "post_ops"), f(self.prepack_weights, "prepack_weights"));
     }
 
     template <class Self, class F>
@@ -160,6 +168,16 @@ struct dnnl_op : auto_register_op<Derived>
 #endif
         return str == nullptr ? "" : str;
     }
+    static dnnl::memory::desc weights_desc(const Primitive& prim)
+    {
+        auto desc = prim.get_primitive_desc();
+#ifdef MIGRAPHX_ENABLE_ZENDNN
+        const auto* md = zendnn_primitive_desc_query_md(desc, zendnn_query_weights_md, 0);
+#else
+        const auto* md = dnnl_primitive_desc_query_md(desc, dnnl_query_weights_md, 0);
+#endif
+        return dnnl::memory::desc(*md);
+    }
     // Map arg index to arg in dnnl
     std::vector<int> arg_map(int size) const
     {
@@ -233,7 +251,14 @@ struct dnnl_op : auto_register_op<Derived>
         assert(m.size() >= inputs.size());
         for(int i = 0; i < inputs.size(); i++)
         {
-            result[m[i]] = to_dnnl_memory_desc(self.adjust_shape(inputs[i], i, output_shape));
+            auto s = self.adjust_shape(inputs[i], i, output_shape);
+            if(prepack_weights and m[i] == MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS))
+                // Let the primitive pick the layout of the weights
+                result[m[i]] = dnnl::memory::desc(to_dnnl_dims(s.lens()),
+                                                  to_dnnl_memory_data_type(s.type()),
+                                                  dnnl::memory::format_tag::any);
+            else
+                result[m[i]] = to_dnnl_memory_desc(s);
         }
         return result;
     }
@@ -305,6 +330,11 @@ struct dnnl_op : auto_register_op<Derived>
         auto md          = to_memory_desc(output_shape, inputs);
         auto prim        = get_primitive(md);
         auto arg_lookup  = create_arg_map(inputs.size());
+        auto exec_md     = md;
+        auto packed      = prepack_weights ? find_packed_weights(prim, output_shape, inputs)
+                                           : std::shared_ptr<packed_weights>{};
+        if(packed != nullptr)
+            exec_md[MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS)] = packed->desc;
 #ifndef NDEBUG
         auto prim_attr = get_primitive_attr(md);
 #endif
@@ -374,13 +404,60 @@ struct dnnl_op : auto_register_op<Derived>
 #endif
             std::unordered_map<int, dnnl::memory> m;
             m[MIGRAPHX_DNNL_PREFIX(ARG_DST)] =
-                to_dnnl_memory(md.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)), args.back());
+                to_dnnl_memory(exec_md.at(MIGRAPHX_DNNL_PREFIX(ARG_DST)), args.back());
             for(int i = 0; i < args.size() - 1; i++)
-                m[arg_lookup[i]] = to_dnnl_memory(md.at(arg_lookup[i]), args[i]);
-            prim.execute(get_dnnl_context().stream, m);
+            {
+                if(packed != nullptr and i == packed->index)
+                    m[arg_lookup[i]] = packed->get(args[i]);
+                else
+                    m[arg_lookup[i]] = to_dnnl_memory(exec_md.at(arg_lookup[i]), args[i]);
+            }
+            prim.execute(get_dnnl_stream(), m);
             return args.back();
         };
     }
+    // Weights reordered into the layout chosen by the primitive, which is
+    // done on the first execution and shared by every copy of the operator.
+    // The copy is in addition to the plain weights, unless the layouts match.
+    struct packed_weights
+    {
+        int index = 0;
+        dnnl::memory::desc plain;
+        dnnl::memory::desc desc;
+        std::once_flag flag;
+        dnnl::memory memory;
+
+        dnnl::memory get(const argument& weights)
+        {
+            if(desc == plain)
+                return to_dnnl_memory(plain, weights);
+            std::call_once(flag, [&] {
+                auto src = to_dnnl_memory(plain, weights);
+                memory   = dnnl::memory(desc, get_dnnl_context().engine);
+                auto& s  = get_dnnl_stream();
+                dnnl::reorder(src, memory).execute(s, src, memory);
+                s.wait();
+            });
+            return memory;
+        }
+    };
+    std::shared_ptr<packed_weights> find_packed_weights(const Primitive& prim,
+                                                        const shape& output_shape,
+                                                        const std::vector<shape>& inputs) const
+    {
+        const auto& self = static_cast<const Derived&>(*this);
+        auto arg_lookup  = create_arg_map(inputs.size());
+        auto it =
+            std::find(arg_lookup.begin(), arg_lookup.end(), MIGRAPHX_DNNL_PREFIX(ARG_WEIGHTS));
+        if(it == arg_lookup.end())
+            return nullptr;
+        auto result   = std::make_shared<packed_weights>();
+        result->index = it - arg_lookup.begin();
+        result->plain = to_dnnl_memory_desc(
+            self.adjust_shape(inputs[result->index], result->index, output_shape));
+        result->desc = weights_desc(prim);
+        return result;
+    }
     std::vector<shape> trim_post_op_inputs(const std::vector<shape>& inputs) const
     {
         auto prim_input_size = inputs.size() - this->get_extra_post_op_args();
@@ -414,6 +491,15 @@ struct dnnl_extend_op : dnnl_op<Derived, Primitive>
         this->get_primitive(this->to_memory_desc(r, inputs));
         return r;
     }
+
+    std::size_t flops(std::vector<shape> inputs) const
+    {
+        if(inputs.empty())
+            return 0;
+        // Compensate for allocation
+        inputs.pop_back();
+        return operation(op).flops(this->trim_post_op_inputs(inputs));
+    }
 };
 
 } // namespace cpu
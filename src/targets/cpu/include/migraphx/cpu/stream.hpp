@@ -0,0 +1,92 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_STREAM_HPP
+#define MIGRAPHX_GUARD_AMDMIGRAPHX_CPU_STREAM_HPP
+
+#include <migraphx/config.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+/// Tracks how many times an event has been recorded on a stream and how many
+/// of those records have been reached, so it can be reused across evaluations
+struct event
+{
+    /// Called when the record is issued, returns the count to wait for
+    std::size_t record();
+    /// Called when the stream reaches the record
+    void complete();
+    /// Block until the record count n has been reached
+    void wait(std::size_t n);
+    /// The count of the last record issued
+    std::size_t last() const;
+
+    private:
+    std::size_t recorded  = 0;
+    std::size_t completed = 0;
+    mutable std::mutex m;
+    std::condition_variable cv;
+};
+
+/// A queue of tasks that are run in order by a single worker thread. Tasks
+/// using bulk_execute share the process thread pool with every other stream.
+struct stream
+{
+    stream();
+
+    stream(const stream&) = delete;
+    stream& operator=(const stream&) = delete;
+
+    ~stream();
+
+    void push(std::function<void()> f);
+
+    /// Wait for all the tasks pushed so far. The first exception thrown by a
+    /// task is rethrown here.
+    void sync();
+
+    private:
+    void work();
+
+    std::deque<std::function<void()>> tasks;
+    bool busy = false;
+    bool stop = false;
+    std::exception_ptr error;
+    std::mutex m;
+    std::condition_variable cv;
+    std::thread worker;
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
@@ -57,6 +57,7 @@
 #include <migraphx/match/gelu_erf.hpp>
 #include <migraphx/match/gelu_tanh.hpp>
 #include <migraphx/matcher.hpp>
+#include <migraphx/stringutils.hpp>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -145,6 +146,10 @@ struct cpu_im2col
 };
 MIGRAPHX_REGISTER_OP(cpu_im2col)
 
+// Runs the reference implementation of an operator that has no cpu kernel.
+// The implementation allocates its own result, so the first allocation of
+// the output's size is given the planned output buffer and any others come
+// from the arena of the context.
 struct cpu_op
 {
     operation op = op::identity{};
@@ -154,10 +159,46 @@ struct cpu_op
         return migraphx::reflect(self.op, f);
     }
     std::string name() const { return "cpu::op"; }
-    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
-    argument compute(context&, const shape& output_shape, const std::vector<argument>& args) const
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return op.compute_shape(inputs);
+    }
+    std::size_t flops(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.flops(inputs);
+    }
+    std::size_t bytes(std::vector<shape> inputs) const
+    {
+        inputs.pop_back();
+        return op.bytes(inputs);
+    }
+    argument compute(context& ctx, const shape& output_shape, std::vector<argument> args) const
+    {
+        auto output = args.back();
+        args.pop_back();
+        bool output_given = false;
+        argument result;
+        {
+            argument_allocator_scope scope{[&](std::size_t n) {
+                if(output_given or n != output.get_shape().bytes())
+                    return ctx.get_arena().allocate(n);
+                output_given = true;
+                std::fill(output.data(), output.data() + n, 0);
+                return std::shared_ptr<char>(output.data(), [](char*) {});
+            }};
+            result = op.compute(output_shape, args);
+        }
+        if(result.data() != output.data())
+            visit_all(output, result)(
+                [&](auto out, auto in) { std::copy(in.begin(), in.end(), out.begin()); });
+        return output;
+    }
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
     {
-        return op.compute(output_shape, args);
+        return shapes.size() - 1;
     }
     value to_value() const
     {
@@ -178,6 +219,20 @@ struct cpu_op
 };
 MIGRAPHX_REGISTER_OP(cpu_op)
 
+// Starts an evaluation of a module that runs cpu_op, so the buffers of the
+// arena are handed out from the start of its block again
+struct cpu_reset_arena
+{
+    std::string name() const { return "cpu::reset_arena"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.get_arena().reset();
+        return {};
+    }
+};
+MIGRAPHX_REGISTER_OP(cpu_reset_arena)
+
 struct cpu_pad
 {
     op::pad op;
@@ -200,14 +255,13 @@ struct cpu_pad
         });
 
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
-                std::transform(
-                    idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
-                        return i + j;
-                    });
-                output(new_idx.begin(), new_idx.end()) = input(idx.begin(), idx.end());
-            });
+            // View the interior of the output with the input's lens
+            const auto& out_s = output.get_shape();
+            shape window{out_s.type(), input.get_shape().lens(), out_s.strides()};
+            auto* start = output.data() + out_s.index(std::vector<std::size_t>(
+                                              op.pads.begin(), op.pads.begin() + out_s.ndim()));
+            shape_for_each_offset(window, input.get_shape())(
+                [&](auto i, auto j) { start[i] = input.data()[j]; });
         });
 
         return result;
@@ -265,6 +319,7 @@ MIGRAPHX_REGISTER_OP(cpu_rnn_var_sl_last_output)
 struct cpu_apply
 {
     module* modl;
+    context* ctx = nullptr;
     std::unordered_map<std::string, std::function<instruction_ref(instruction_ref)>> apply_map{};
     instruction_ref last{};
 
@@ -301,6 +356,8 @@ struct cpu_apply
     {
         return match::make_match_finder(matcher, [=](auto&, const auto& r) {
             auto ins = r.result;
+            if(ins->get_shape().type() != shape::float_type)
+                return;
             std::vector<instruction_ref> inputs;
             std::transform(bind_inputs.begin(),
                            bind_inputs.end(),
@@ -347,10 +404,12 @@ struct cpu_apply
 #ifndef MIGRAPHX_ENABLE_ZENDNN
         extend_op("deconvolution", "dnnl::deconvolution");
         extend_op("dot", "dnnl::dot");
+        extend_op("quant_dot", "dnnl::quant_dot");
 #endif
         extend_op("erf", "cpu::erf");
         extend_op("gather", "cpu::gather");
         extend_op("logsoftmax", "dnnl::logsoftmax");
+        extend_op("quant_convolution", "dnnl::quant_convolution");
         extend_op("lrn", "dnnl::lrn");
         extend_op("softmax", "dnnl::softmax");
         extend_op("sub", "cpu::sub");
@@ -391,9 +450,31 @@ struct cpu_apply
             {
                 apply_map.at(it->name())(it);
             }
+            // Also catches operators dnnl has no kernel for in their data type
+            if(use_cpu_op(it))
+            {
+                replace(it, cpu_op{it->get_operator()});
+            }
         }
     }
 
+    // Operators left without a cpu kernel that compute a new buffer are run
+    // through cpu::op, so their result goes to an allocation planned by
+    // memory_coloring instead of the heap
+    static bool use_cpu_op(instruction_ref ins)
+    {
+        if(ins->name().front() == '@' or contains(ins->name(), "::") or
+           contains({"allocate", "load", "pointwise"}, ins->name()))
+            return false;
+        if(ins->inputs().empty() or not ins->module_inputs().empty())
+            return false;
+        const auto& s = ins->get_shape();
+        if(s.dynamic() or s.type() == shape::tuple_type or s.elements() == 0)
+            return false;
+        auto&& op = ins->get_operator();
+        return is_context_free(op) and op.output_alias(to_shapes(ins->inputs())) < 0;
+    }
+
     instruction_ref apply_pow(instruction_ref ins) const
     {
         auto beta = read_scalar<float>(ins->inputs()[1]);
@@ -436,8 +517,89 @@ struct cpu_apply
     instruction_ref
     replace(instruction_ref ins, const operation& op, std::vector<instruction_ref> inputs) const
     {
-        inputs.push_back(insert_allocation(ins, ins->get_shape()));
-        return modl->replace_instruction(ins, op, inputs);
+        if(is_float(ins, inputs) or has_kernel(op, to_shapes(inputs), ins->get_shape()))
+        {
+            inputs.push_back(insert_allocation(ins, ins->get_shape()));
+            return modl->replace_instruction(ins, op, inputs);
+        }
+        return replace_with_float(ins, op, inputs);
+    }
+
+    static bool is_float(instruction_ref ins, const std::vector<instruction_ref>& inputs)
+    {
+        return ins->get_shape().type() == shape::float_type and
+               std::all_of(inputs.begin(), inputs.end(), [](auto input) {
+                   return input->get_shape().type() == shape::float_type;
+               });
+    }
+
+    // Whether the operator has a kernel for these shapes other than the
+    // reference implementation of dnnl
+    bool has_kernel(operation op, std::vector<shape> inputs, const shape& output) const
+    {
+        inputs.push_back(output);
+        auto new_shape = try_compute_shape(op, inputs);
+        if(new_shape.empty())
+            return false;
+        context local{};
+        // dnnl fails to create the primitive for types it has no kernel for
+        try
+        {
+            auto info = compile(op, ctx == nullptr ? local : *ctx, new_shape.front(), inputs);
+            return not(info.contains("impl") and
+                       starts_with(info.at("impl").to<std::string>(), "ref:"));
+        }
+        catch(const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    // Without a native kernel, types that convert exactly to float are
+    // computed in float with converts around the operator. Other types are
+    // left to the reference implementation in their own precision.
+    instruction_ref replace_with_float(instruction_ref ins,
+                                       const operation& op,
+                                       const std::vector<instruction_ref>& inputs) const
+    {
+        auto exact = [](shape::type_t t) {
+            return contains(
+                {shape::float_type, shape::half_type, shape::int8_type, shape::uint8_type}, t);
+        };
+        if(not std::all_of(inputs.begin(), inputs.end(), [&](auto input) {
+               return exact(input->get_shape().type());
+           }))
+            return ins;
+        auto float_op   = op;
+        auto attributes = ins->get_operator().attributes();
+        if(attributes.contains("general_data_type"))
+            float_op = make_op("dnnl::" + attributes["general_data_type"].to<std::string>(),
+                               op.to_value());
+        std::vector<instruction_ref> float_inputs;
+        std::transform(inputs.begin(),
+                       inputs.end(),
+                       std::back_inserter(float_inputs),
+                       [&](auto input) -> instruction_ref {
+                           if(input->get_shape().type() == shape::float_type)
+                               return input;
+                           return insert_convert(ins, input, shape::float_type);
+                       });
+        float_inputs.push_back(
+            insert_allocation(ins, ins->get_shape().with_type(shape::float_type)));
+        auto out     = modl->insert_instruction(ins, float_op, float_inputs);
+        auto convert = make_op("convert", {{"target_type", ins->get_shape().type()}});
+        auto alloc   = insert_allocation(ins, convert.compute_shape({out->get_shape()}));
+        return modl->replace_instruction(ins, cpu_op{convert}, out, alloc);
+    }
+
+    // The converts are inserted before the instruction being lowered, which
+    // the loop in apply has already passed, so they are lowered here
+    instruction_ref
+    insert_convert(instruction_ref ins, instruction_ref input, shape::type_t t) const
+    {
+        auto convert = make_op("convert", {{"target_type", t}});
+        auto alloc   = insert_allocation(ins, convert.compute_shape({input->get_shape()}));
+        return modl->insert_instruction(ins, cpu_op{convert}, input, alloc);
     }
 
     instruction_ref insert_allocation(instruction_ref ins, const shape& s) const
@@ -446,7 +608,7 @@ struct cpu_apply
     }
 };
 
-void lowering::apply(module& m) const { cpu_apply{&m}.apply(); }
+void lowering::apply(module& m) const { cpu_apply{&m, ctx}.apply(); }
 
 } // namespace cpu
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,271 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/operation.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/op/identity.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct record_event
+{
+    std::size_t event = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"));
+    }
+    std::string name() const { return "cpu::record_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.record_event(event);
+        return {};
+    }
+
+    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    {
+        ctx.create_events(event);
+    }
+};
+
+struct wait_event
+{
+    std::size_t event = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.event, "event"));
+    }
+    std::string name() const { return "cpu::wait_event"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.wait_event(event);
+        return {};
+    }
+};
+
+struct set_stream
+{
+    std::size_t stream = 0;
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.stream, "stream"));
+    }
+    std::string name() const { return "cpu::set_stream"; }
+    shape compute_shape(const std::vector<shape>&) const { return {}; }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>&) const
+    {
+        ctx.set_stream(stream);
+        return {};
+    }
+    void finalize(context& ctx, const shape&, const std::vector<shape>&) const
+    {
+        ctx.set_stream(stream);
+    }
+};
+
+// Waits for every stream before the values of the module are returned, and
+// rethrows the first error of the operators that ran on them
+struct sync_streams
+{
+    std::string name() const { return "cpu::sync_streams"; }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty())
+            return {};
+        return inputs.front();
+    }
+
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        ctx.finish();
+        if(args.empty())
+            return {};
+        return args.front();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.empty() ? -1 : 0;
+    }
+};
+
+// Runs an instruction scheduled on a stream other than 0. When the operator
+// only writes into its output allocation the result is known before it is
+// computed, so the computation is pushed to the stream and the allocation is
+// returned right away. Otherwise the stream is drained and the operator is
+// computed on the calling thread.
+struct stream_op
+{
+    operation op = op::identity{};
+    bool async   = false;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.op, "op"), f(self.async, "async"));
+    }
+
+    std::string name() const { return "cpu::stream_op"; }
+
+    shape compute_shape(const std::vector<shape>& inputs, const std::vector<module_ref>& mods) const
+    {
+        return op.compute_shape(inputs, mods);
+    }
+
+    argument
+    compute(context& ctx,
+            const shape& output_shape,
+            const std::vector<argument>& args,
+            const std::vector<module_ref>& mods,
+            const std::function<std::vector<argument>(
+                module_ref&, const std::unordered_map<std::string, argument>&)>& run) const
+    {
+        if(async)
+        {
+            ctx.enqueue([this, &ctx, output_shape, args] {
+                migraphx::context gctx = std::ref(ctx);
+                op.compute(gctx, output_shape, args);
+            });
+            return args.back();
+        }
+        ctx.sync(ctx.stream_id());
+        migraphx::context gctx = std::ref(ctx);
+        return op.compute(gctx, output_shape, args, mods, run);
+    }
+
+    void finalize(context& ctx, const shape& output_shape, const std::vector<shape>& inputs)
+    {
+        migraphx::context gctx = std::ref(ctx);
+        op.finalize(gctx, output_shape, inputs);
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return op.output_alias(shapes);
+    }
+};
+
+MIGRAPHX_REGISTER_OP(record_event)
+MIGRAPHX_REGISTER_OP(wait_event)
+MIGRAPHX_REGISTER_OP(set_stream)
+MIGRAPHX_REGISTER_OP(stream_op)
+MIGRAPHX_REGISTER_OP(sync_streams)
+
+// Whether the value of the instruction is returned by the module, directly or
+// through views of it
+static bool is_returned(instruction_ref ins)
+{
+    // The last instruction is returned when there is no @return
+    if(ins->outputs().empty())
+        return true;
+    return std::any_of(ins->outputs().begin(), ins->outputs().end(), [&](auto output) {
+        if(output->name() == "@return")
+            return true;
+        auto alias = output->get_operator().output_alias(to_shapes(output->inputs()));
+        if(alias < 0 or output->inputs().at(alias) != ins)
+            return false;
+        return is_returned(output);
+    });
+}
+
+static bool is_async(instruction_ref ins)
+{
+    if(ins->inputs().empty() or not ins->module_inputs().empty())
+        return false;
+    // Returned values must be ready when eval returns
+    if(is_returned(ins))
+        return false;
+    auto alias = ins->get_operator().output_alias(to_shapes(ins->inputs()));
+    std::ptrdiff_t last = ins->inputs().size() - 1;
+    return alias == last and ins->inputs().back()->name() == "cpu::allocate";
+}
+
+std::size_t schedule_model::concurrency() const { return streams; }
+void schedule_model::sched(module& m, instruction_ref ins, std::size_t n) const
+{
+    auto last_stream = std::find_if(std::make_reverse_iterator(ins),
+                                    std::make_reverse_iterator(m.begin()),
+                                    [&](auto&& i) { return i.name() == "cpu::set_stream"; });
+    // If the same stream was set earlier then skip
+    if(last_stream == std::make_reverse_iterator(m.begin()) or
+       any_cast<set_stream>(last_stream->get_operator()).stream != n)
+        m.insert_instruction(ins, set_stream{n});
+    // Stream 0 is the calling thread, so it runs the instruction as is
+    if(n == 0)
+        return;
+    m.replace_instruction(
+        ins, stream_op{ins->get_operator(), is_async(ins)}, ins->inputs(), ins->module_inputs());
+}
+
+void schedule_model::wait(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(ins, wait_event{wait_id});
+}
+void schedule_model::record(module& m, instruction_ref ins, std::size_t wait_id) const
+{
+    m.insert_instruction(std::next(ins), record_event{wait_id});
+}
+
+static std::unordered_map<std::string, std::size_t> create_weight_map()
+{
+    return {{"cpu::allocate", 0},
+            {"cpu::literal", 0},
+            {"dnnl::convolution", 8},
+            {"dnnl::deconvolution", 8},
+            {"dnnl::dot", 4},
+            {"dnnl::pooling", 4}};
+}
+
+static const std::unordered_map<std::string, std::size_t>& weight_map()
+{
+    static const std::unordered_map<std::string, std::size_t> m = create_weight_map();
+    return m;
+}
+
+std::size_t schedule_model::weight(const operation& op) const
+{
+    if(weight_map().count(op.name()) == 0)
+    {
+        return 2;
+    }
+    return weight_map().at(op.name());
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
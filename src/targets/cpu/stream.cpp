@@ -0,0 +1,122 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/stream.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+std::size_t event::record()
+{
+    std::lock_guard<std::mutex> lock(m);
+    return ++recorded;
+}
+
+void event::complete()
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        completed++;
+    }
+    cv.notify_all();
+}
+
+void event::wait(std::size_t n)
+{
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return completed >= n; });
+}
+
+std::size_t event::last() const
+{
+    std::lock_guard<std::mutex> lock(m);
+    return recorded;
+}
+
+stream::stream() : worker([this] { this->work(); }) {}
+
+stream::~stream()
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stop = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+void stream::push(std::function<void()> f)
+{
+    {
+        std::lock_guard<std::mutex> lock(m);
+        tasks.push_back(std::move(f));
+    }
+    cv.notify_all();
+}
+
+void stream::sync()
+{
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [&] { return tasks.empty() and not busy; });
+    if(error)
+    {
+        auto e = error;
+        error  = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void stream::work()
+{
+    std::unique_lock<std::mutex> lock(m);
+    for(;;)
+    {
+        cv.wait(lock, [&] { return stop or not tasks.empty(); });
+        // Finish the pending tasks before stopping
+        if(tasks.empty())
+            return;
+        auto f = std::move(tasks.front());
+        tasks.pop_front();
+        busy = true;
+        lock.unlock();
+        std::exception_ptr e;
+        try
+        {
+            f();
+        }
+        catch(...)
+        {
+            e = std::current_exception();
+        }
+        lock.lock();
+        if(e and not error)
+            error = e;
+        busy = false;
+        cv.notify_all();
+    }
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -29,9 +29,9 @@
 #include <migraphx/eliminate_common_subexpression.hpp>
 #include <migraphx/eliminate_concat.hpp>
 #include <migraphx/eliminate_contiguous.hpp>
-#include <migraphx/eliminate_data_type.hpp>
 #include <migraphx/eliminate_identity.hpp>
 #include <migraphx/eliminate_pad.hpp>
+#include <migraphx/fuse_pointwise.hpp>
 #include <migraphx/layout_nhwc.hpp>
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/propagate_constant.hpp>
@@ -45,33 +45,36 @@
 #include <migraphx/simplify_qdq.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
+#include <migraphx/cpu/compile_pointwise.hpp>
+#include <migraphx/cpu/finish_streams.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/prepack_weights.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
 #include <migraphx/cpu/target.hpp>
 #include <migraphx/cpu/context.hpp>
 #include <migraphx/cpu/lowering.hpp>
-#include <migraphx/pass.hpp>
+#include <migraphx/cpu/schedule_model.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/env.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 namespace cpu {
 
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_POINTWISE_FUSION)
+
 std::string target::name() const { return "cpu"; }
 
 // cppcheck-suppress constParameter
 std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options&) const
 {
     auto& ctx = any_cast<context>(gctx);
-    std::set<shape::type_t> unsupported_types(shape::types().begin(), shape::types().end());
-    unsupported_types.erase(shape::type_t::float_type);
     return {normalize_ops{},
             rewrite_quantization{},
             dead_code_elimination{},
-            eliminate_data_type{unsupported_types, shape::type_t::float_type},
-            dead_code_elimination{},
             simplify_reshapes{},
             eliminate_identity{},
             eliminate_pad{},
@@ -90,7 +93,13 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_reshapes{},
             propagate_constant{},
             dead_code_elimination{},
-            lowering{},
+            enable_pass(not enabled(MIGRAPHX_DISABLE_POINTWISE_FUSION{}), fuse_pointwise{}),
+            dead_code_elimination{},
+            // Runs before lowering, so the modules it does not compile are
+            // inlined back for lowering and fuse_ops to map onto dnnl
+            enable_pass(not enabled(MIGRAPHX_DISABLE_POINTWISE_FUSION{}), compile_pointwise{}),
+            dead_code_elimination{},
+            lowering{&ctx},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
             replace_allocate{cpu_allocation_model{}},
@@ -99,8 +108,11 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             dead_code_elimination{},
             fuse_ops{&ctx},
             dead_code_elimination{},
+            prepack_weights{},
             write_literals{},
             dead_code_elimination{},
+            schedule{cpu::schedule_model{ctx.nstreams()}, ctx.nstreams() > 1},
+            finish_streams{},
             memory_coloring{"cpu::allocate"},
             dead_code_elimination{},
             preallocate_param{"scratch", cpu_allocation_model{}},
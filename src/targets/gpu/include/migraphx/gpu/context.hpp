@@ -265,6 +265,8 @@ struct context
         value result;
         result["events"]  = events.size();
         result["streams"] = current_device->nstreams();
+        // Identifies the device the program is compiled for
+        result["device"] = get_device_name();
 
         return result;
     }
@@ -302,6 +304,19 @@ struct context
 
     any_ptr get_queue() { return get_stream().get(); }
 
+    context fork() const
+    {
+        context result(get_device_id(), current_device->nstreams());
+        // The streams, handles and events are new, but the literals copied to
+        // the device are shared
+        result.current_device->preallocations = current_device->preallocations;
+        result.literals                       = literals;
+        result.exhaustive_tune                = exhaustive_tune;
+        if(not events.empty())
+            result.create_events(events.size() - 1);
+        return result;
+    }
+
     void enable_perf_measurement(bool b = true)
     {
         if(b)
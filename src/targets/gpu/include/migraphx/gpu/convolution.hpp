@@ -89,6 +89,13 @@ struct miopen_convolution
         return migraphx::compute_shape<Op>(op, conv_inputs);
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.size() < 2)
+            return 0;
+        return op.flops({inputs[0], inputs[1]});
+    }
+
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
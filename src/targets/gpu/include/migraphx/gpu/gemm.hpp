@@ -108,6 +108,13 @@ struct rocblas_gemm
         return transpose_batch(op.compute_shape(in_shapes), trans_batch);
     }
 
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.size() < 2)
+            return 0;
+        return op.flops({inputs[0], inputs[1]});
+    }
+
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
     {
@@ -29,6 +29,7 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/check_shapes.hpp>
 #include <migraphx/functional.hpp>
+#include <migraphx/lifetime.hpp>
 #include <utility>
 
 namespace migraphx {
@@ -200,6 +201,8 @@ struct hip_allocate_memory
         argument a = allocate_gpu(s);
         store_preallocated_param(ctx, id, a);
     }
+
+    lifetime get_lifetime() const { return lifetime::global; }
 };
 
 struct hip_copy_literal
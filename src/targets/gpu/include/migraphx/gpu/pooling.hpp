@@ -48,6 +48,12 @@ struct miopen_pooling
 
     std::string name() const { return "gpu::pooling"; }
     shape compute_shape(const std::vector<shape>& inputs) const;
+    std::size_t flops(const std::vector<shape>& inputs) const
+    {
+        if(inputs.empty())
+            return 0;
+        return op.flops({inputs.front()});
+    }
     void finalize(context&, const shape&, const std::vector<shape>&);
     argument
     compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const;
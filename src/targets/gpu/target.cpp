@@ -39,6 +39,7 @@
 #include <migraphx/memory_coloring.hpp>
 #include <migraphx/normalize_ops.hpp>
 #include <migraphx/optimize_module.hpp>
+#include <migraphx/pass_manager.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/propagate_constant.hpp>
 #include <migraphx/register_target.hpp>
@@ -74,18 +75,6 @@ namespace gpu {
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_SCHEDULE_PASS)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_POINTWISE_FUSION)
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_ENABLE_NHWC)
-struct id_pass
-{
-    std::string name() const { return "id"; }
-    void apple(const module&) const {}
-};
-
-pass enable_pass(bool enabled, pass p)
-{
-    if(enabled)
-        return p;
-    return id_pass{};
-}
 
 std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_options& options) const
 {
@@ -0,0 +1,441 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/ref/convolution.hpp>
+#include <migraphx/gemm.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/shape.hpp>
+#include <migraphx/tensor_view.hpp>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace ref {
+
+// Upper bound on the number of elements in the temporary buffers, large
+// images are processed in chunks of output positions to stay below it
+constexpr std::size_t conv_workspace_size = std::size_t{1} << 22;
+
+template <class Iterator>
+static std::size_t product(Iterator start, Iterator last)
+{
+    return std::accumulate(start, last, std::size_t{1}, std::multiplies<>{});
+}
+
+static bool all_ones(const std::vector<std::size_t>& v)
+{
+    return std::all_of(v.begin(), v.end(), [](auto x) { return x == 1; });
+}
+
+conv_algo select_conv_algo(const shape& input,
+                           const shape& weights,
+                           const std::vector<std::size_t>& stride,
+                           const std::vector<std::size_t>& dilation,
+                           std::size_t group)
+{
+    const auto& wei_lens = weights.lens();
+    // Depthwise convolutions reuse too little data to be worth packing for a gemm
+    if(group > 1 and wei_lens[1] == 1)
+        return conv_algo::direct;
+    bool is_float = contains({shape::half_type, shape::float_type, shape::double_type},
+                             input.type());
+    // The transforms only pay off when there are enough channels to amortize them
+    if(is_float and group == 1 and wei_lens.size() == 4 and wei_lens[2] == 3 and
+       wei_lens[3] == 3 and all_ones(stride) and all_ones(dilation) and wei_lens[0] >= 16 and
+       wei_lens[1] >= 16)
+        return conv_algo::winograd;
+    return conv_algo::im2col;
+}
+
+// Sizes and precomputed spatial offsets of a convolution on standard tensors
+struct conv_geometry
+{
+    std::size_t batch    = 0;
+    std::size_t channels = 0;
+    std::size_t kernels  = 0;
+    // Channels and kernels in each group
+    std::size_t cg = 0;
+    std::size_t kg = 0;
+    // Number of spatial dimensions
+    std::size_t nd = 0;
+    // Elements in the spatial dimensions of the output, the kernel and the input
+    std::size_t out_plane    = 0;
+    std::size_t kernel_plane = 0;
+    std::size_t in_plane     = 0;
+    std::vector<std::size_t> in_spatial;
+    std::vector<std::size_t> out_spatial;
+    std::vector<std::size_t> in_strides;
+    std::vector<std::size_t> padding;
+    // First input position read by each output position, for every dimension
+    std::vector<std::ptrdiff_t> base;
+    // Distance of each kernel position from the first input position
+    std::vector<std::ptrdiff_t> koffsets;
+    // The kernel reads exactly the input position of each output
+    bool pointwise = false;
+
+    conv_geometry(const shape& input,
+                  const shape& weights,
+                  const shape& output,
+                  const std::vector<std::size_t>& pads,
+                  const std::vector<std::size_t>& stride,
+                  const std::vector<std::size_t>& dilation,
+                  std::size_t group)
+    {
+        const auto& in_lens  = input.lens();
+        const auto& wei_lens = weights.lens();
+        const auto& out_lens = output.lens();
+        batch                = in_lens[0];
+        channels             = in_lens[1];
+        kernels              = wei_lens[0];
+        cg                   = wei_lens[1];
+        kg                   = kernels / group;
+        nd                   = in_lens.size() - 2;
+        in_spatial.assign(in_lens.begin() + 2, in_lens.end());
+        out_spatial.assign(out_lens.begin() + 2, out_lens.end());
+        padding.assign(pads.begin(), pads.begin() + nd);
+        in_plane     = product(in_spatial.begin(), in_spatial.end());
+        out_plane    = product(out_spatial.begin(), out_spatial.end());
+        kernel_plane = product(wei_lens.begin() + 2, wei_lens.end());
+
+        in_strides.resize(nd);
+        std::size_t s = 1;
+        for(std::size_t d = nd; d > 0; d--)
+        {
+            in_strides[d - 1] = s;
+            s *= in_spatial[d - 1];
+        }
+
+        base.resize(out_plane * nd);
+        std::vector<std::size_t> idx(nd, 0);
+        for(std::size_t p = 0; p < out_plane; p++)
+        {
+            for(std::size_t d = 0; d < nd; d++)
+                base[p * nd + d] =
+                    std::ptrdiff_t(idx[d] * stride[d]) - std::ptrdiff_t(padding[d]);
+            next(idx, out_spatial);
+        }
+
+        koffsets.resize(kernel_plane * nd);
+        idx.assign(nd, 0);
+        for(std::size_t ks = 0; ks < kernel_plane; ks++)
+        {
+            for(std::size_t d = 0; d < nd; d++)
+                koffsets[ks * nd + d] = std::ptrdiff_t(idx[d] * dilation[d]);
+            next(idx, {wei_lens.begin() + 2, wei_lens.end()});
+        }
+
+        // The end pads are checked as well, since they add output positions
+        // that only read the padding
+        pointwise = kernel_plane == 1 and all_ones(stride) and out_spatial == in_spatial and
+                    std::all_of(pads.begin(), pads.end(), [](auto x) { return x == 0; });
+    }
+
+    static void next(std::vector<std::size_t>& idx, const std::vector<std::size_t>& lens)
+    {
+        for(std::size_t d = idx.size(); d > 0; d--)
+        {
+            if(++idx[d - 1] < lens[d - 1])
+                return;
+            idx[d - 1] = 0;
+        }
+    }
+
+    std::size_t image() const { return channels * in_plane; }
+
+    std::size_t ck() const { return cg * kernel_plane; }
+
+    // Offset in the input plane read by output position p at kernel
+    // position ks, or -1 when it falls in the padding
+    std::ptrdiff_t input_offset(std::size_t p, std::size_t ks) const
+    {
+        std::ptrdiff_t offset = 0;
+        for(std::size_t d = 0; d < nd; d++)
+        {
+            auto i = base[p * nd + d] + koffsets[ks * nd + d];
+            if(i < 0 or i >= std::ptrdiff_t(in_spatial[d]))
+                return -1;
+            offset += i * std::ptrdiff_t(in_strides[d]);
+        }
+        return offset;
+    }
+};
+
+template <class T>
+static tensor_view<T> make_matrix(T* data, std::size_t rows, std::size_t cols, std::size_t ld)
+{
+    return {shape{shape::get_type<T>{}, {rows, cols}, {ld, 1}}, data};
+}
+
+template <class T>
+static T* standard_data(tensor_view<T> x, std::vector<T>& buffer)
+{
+    if(x.get_shape().standard())
+        return x.data();
+    buffer.assign(x.begin(), x.end());
+    return buffer.data();
+}
+
+// Lowers each group to a gemm between the weights and the unfolded input windows
+template <class O, class T>
+static void conv_im2col(O* out, T* in, T* wei, const conv_geometry& g)
+{
+    using scalar       = std::conditional_t<std::is_integral<O>{}, int32_t, float>;
+    const auto ck      = g.ck();
+    std::size_t chunk  = g.pointwise ? g.out_plane : conv_workspace_size / ck;
+    chunk              = std::max<std::size_t>(1, std::min(chunk, g.out_plane));
+    std::vector<T> col = g.pointwise ? std::vector<T>{} : std::vector<T>(ck * chunk);
+    for(std::size_t n = 0; n < g.batch; n++)
+    {
+        for(std::size_t grp = 0; grp * g.kg < g.kernels; grp++)
+        {
+            T* in_g = in + n * g.image() + grp * g.cg * g.in_plane;
+            auto w  = make_matrix(wei + grp * g.kg * ck, g.kg, ck, ck);
+            for(std::size_t p0 = 0; p0 < g.out_plane; p0 += chunk)
+            {
+                auto pc = std::min(chunk, g.out_plane - p0);
+                auto c  = make_matrix(out + (n * g.kernels + grp * g.kg) * g.out_plane + p0,
+                                     g.kg,
+                                     pc,
+                                     g.out_plane);
+                // The input is already laid out as the unfolded matrix
+                if(g.pointwise)
+                {
+                    gemm(c, w, make_matrix(in_g + p0, ck, pc, g.in_plane), scalar{1}, scalar{0});
+                    continue;
+                }
+                par_for(ck, [&](auto row) {
+                    auto ch = row / g.kernel_plane;
+                    auto ks = row % g.kernel_plane;
+                    T* dst  = col.data() + row * pc;
+                    for(std::size_t p = 0; p < pc; p++)
+                    {
+                        auto offset = g.input_offset(p0 + p, ks);
+                        dst[p]      = offset < 0 ? T(0) : in_g[ch * g.in_plane + offset];
+                    }
+                });
+                gemm(c, w, make_matrix(col.data(), ck, pc, pc), scalar{1}, scalar{0});
+            }
+        }
+    }
+}
+
+// Computes each output element on its own, for convolutions with few
+// channels per group
+template <class O, class T>
+static void conv_direct(O* out, const T* in, const T* wei, const conv_geometry& g)
+{
+    using acc_type = gemm_accumulator<O>;
+    par_for(g.batch * g.kernels * g.out_plane, [&](auto i) {
+        auto p          = i % g.out_plane;
+        auto k          = (i / g.out_plane) % g.kernels;
+        auto n          = i / g.out_plane / g.kernels;
+        const T* in_g   = in + n * g.image() + (k / g.kg) * g.cg * g.in_plane;
+        const T* w      = wei + k * g.ck();
+        acc_type result = 0;
+        for(std::size_t ks = 0; ks < g.kernel_plane; ks++)
+        {
+            auto offset = g.input_offset(p, ks);
+            if(offset < 0)
+                continue;
+            for(std::size_t c = 0; c < g.cg; c++)
+                result += static_cast<acc_type>(in_g[c * g.in_plane + offset]) *
+                          static_cast<acc_type>(w[c * g.kernel_plane + ks]);
+        }
+        out[i] = static_cast<O>(result);
+    });
+}
+
+// Winograd F(2x2, 3x3): each 2x2 output tile is computed from a 4x4 input
+// tile, and the products over the channels become 16 independent gemms
+template <class O, class T>
+static void conv_winograd(O* out, const T* in, const T* wei, const conv_geometry& g)
+{
+    const std::size_t nc = g.channels;
+    const std::size_t nk = g.kernels;
+    const std::ptrdiff_t ih = g.in_spatial[0];
+    const std::ptrdiff_t iw = g.in_spatial[1];
+    const std::size_t oh = g.out_spatial[0];
+    const std::size_t ow = g.out_spatial[1];
+    const std::size_t th = (oh + 1) / 2;
+    const std::size_t tw = (ow + 1) / 2;
+    const auto tiles     = th * tw;
+
+    // u = G w G^T, stored as 16 matrices of nk x nc
+    std::vector<double> u(16 * nk * nc);
+    par_for(nk * nc, [&](auto kc) {
+        const T* w = wei + kc * 9;
+        double gw[4][3];
+        for(std::size_t j = 0; j < 3; j++)
+        {
+            double w0 = w[j];
+            double w1 = w[3 + j];
+            double w2 = w[6 + j];
+            gw[0][j]  = w0;
+            gw[1][j]  = (w0 + w1 + w2) / 2;
+            gw[2][j]  = (w0 - w1 + w2) / 2;
+            gw[3][j]  = w2;
+        }
+        for(std::size_t i = 0; i < 4; i++)
+        {
+            double r[4] = {gw[i][0],
+                           (gw[i][0] + gw[i][1] + gw[i][2]) / 2,
+                           (gw[i][0] - gw[i][1] + gw[i][2]) / 2,
+                           gw[i][2]};
+            for(std::size_t j = 0; j < 4; j++)
+                u[(i * 4 + j) * nk * nc + kc] = r[j];
+        }
+    });
+
+    std::size_t chunk = conv_workspace_size / (16 * std::max(nc, nk));
+    chunk             = std::max<std::size_t>(1, std::min(chunk, tiles));
+    std::vector<double> v(16 * nc * chunk);
+    std::vector<double> m(16 * nk * chunk);
+    for(std::size_t n = 0; n < g.batch; n++)
+    {
+        for(std::size_t t0 = 0; t0 < tiles; t0 += chunk)
+        {
+            auto tc = std::min(chunk, tiles - t0);
+            // v = B^T d B for every input tile d
+            par_for(nc * tc, [&](auto ct) {
+                auto c           = ct / tc;
+                auto t           = t0 + ct % tc;
+                auto y = std::ptrdiff_t(2 * (t / tw)) - std::ptrdiff_t(g.padding[0]);
+                auto x = std::ptrdiff_t(2 * (t % tw)) - std::ptrdiff_t(g.padding[1]);
+                const T* plane   = in + n * g.image() + c * g.in_plane;
+                double d[4][4];
+                for(std::ptrdiff_t i = 0; i < 4; i++)
+                {
+                    for(std::ptrdiff_t j = 0; j < 4; j++)
+                    {
+                        bool inside = y + i >= 0 and y + i < ih and x + j >= 0 and x + j < iw;
+                        d[i][j] = inside ? static_cast<double>(plane[(y + i) * iw + x + j]) : 0.0;
+                    }
+                }
+                double bd[4][4];
+                for(std::size_t j = 0; j < 4; j++)
+                {
+                    bd[0][j] = d[0][j] - d[2][j];
+                    bd[1][j] = d[1][j] + d[2][j];
+                    bd[2][j] = d[2][j] - d[1][j];
+                    bd[3][j] = d[1][j] - d[3][j];
+                }
+                for(std::size_t i = 0; i < 4; i++)
+                {
+                    double r[4] = {bd[i][0] - bd[i][2],
+                                   bd[i][1] + bd[i][2],
+                                   bd[i][2] - bd[i][1],
+                                   bd[i][1] - bd[i][3]};
+                    for(std::size_t j = 0; j < 4; j++)
+                        v[(i * 4 + j) * nc * tc + ct] = r[j];
+                }
+            });
+            tensor_view<double> mv{shape{shape::double_type, {16, nk, tc}}, m.data()};
+            tensor_view<double> uv{shape{shape::double_type, {16, nk, nc}}, u.data()};
+            tensor_view<double> vv{shape{shape::double_type, {16, nc, tc}}, v.data()};
+            gemm(mv, uv, vv, 1.0, 0.0);
+            // y = A^T m A for every output tile
+            par_for(nk * tc, [&](auto kt) {
+                auto k  = kt / tc;
+                auto t  = t0 + kt % tc;
+                auto y  = 2 * (t / tw);
+                auto x  = 2 * (t % tw);
+                auto at = [&](std::size_t i, std::size_t j) {
+                    return m[(i * 4 + j) * nk * tc + kt];
+                };
+                double am[2][4];
+                for(std::size_t j = 0; j < 4; j++)
+                {
+                    am[0][j] = at(0, j) + at(1, j) + at(2, j);
+                    am[1][j] = at(1, j) - at(2, j) - at(3, j);
+                }
+                O* plane = out + (n * nk + k) * g.out_plane;
+                for(std::size_t i = 0; i < 2 and y + i < oh; i++)
+                {
+                    double r[2] = {am[i][0] + am[i][1] + am[i][2], am[i][1] - am[i][2] - am[i][3]};
+                    for(std::size_t j = 0; j < 2 and x + j < ow; j++)
+                        plane[(y + i) * ow + x + j] = static_cast<O>(r[j]);
+                }
+            });
+        }
+    }
+}
+
+template <class O, class T>
+static void convolution_impl(tensor_view<O> output,
+                             tensor_view<T> input,
+                             tensor_view<T> weights,
+                             const std::vector<std::size_t>& padding,
+                             const std::vector<std::size_t>& stride,
+                             const std::vector<std::size_t>& dilation,
+                             std::size_t group)
+{
+    assert(output.get_shape().standard());
+    std::vector<T> in_buffer;
+    std::vector<T> wei_buffer;
+    T* in  = standard_data(input, in_buffer);
+    T* wei = standard_data(weights, wei_buffer);
+    conv_geometry g{input.get_shape(),
+                    weights.get_shape(),
+                    output.get_shape(),
+                    padding,
+                    stride,
+                    dilation,
+                    group};
+    switch(select_conv_algo(input.get_shape(), weights.get_shape(), stride, dilation, group))
+    {
+    case conv_algo::winograd: conv_winograd(output.data(), in, wei, g); break;
+    case conv_algo::direct: conv_direct(output.data(), in, wei, g); break;
+    case conv_algo::im2col: conv_im2col(output.data(), in, wei, g); break;
+    }
+}
+
+void convolution(const argument& result,
+                 const argument& input,
+                 const argument& weights,
+                 const std::vector<std::size_t>& padding,
+                 const std::vector<std::size_t>& stride,
+                 const std::vector<std::size_t>& dilation,
+                 std::size_t group)
+{
+    if(result.get_shape().type() == input.get_shape().type())
+    {
+        visit_all(result, input, weights)([&](auto output, auto x, auto w) {
+            convolution_impl(output, x, w, padding, stride, dilation, group);
+        });
+    }
+    else
+    {
+        // Quantized convolutions accumulate into int32
+        visit_all(input, weights)([&](auto x, auto w) {
+            convolution_impl(result.get<int32_t>(), x, w, padding, stride, dilation, group);
+        });
+    }
+}
+
+} // namespace ref
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
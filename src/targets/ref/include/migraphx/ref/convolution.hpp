@@ -0,0 +1,64 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_RTGLIB_REF_CONVOLUTION_HPP
+#define MIGRAPHX_GUARD_RTGLIB_REF_CONVOLUTION_HPP
+
+#include <migraphx/argument.hpp>
+#include <migraphx/config.hpp>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace ref {
+
+enum class conv_algo
+{
+    im2col,
+    direct,
+    winograd
+};
+
+/// Picks the algorithm used to compute a convolution from its shapes
+conv_algo select_conv_algo(const shape& input,
+                           const shape& weights,
+                           const std::vector<std::size_t>& stride,
+                           const std::vector<std::size_t>& dilation,
+                           std::size_t group);
+
+/// Computes the convolution into result, where padding holds the padding at
+/// the beginning of each spatial dimension (any padding after that is implied
+/// by the shape of result)
+void convolution(const argument& result,
+                 const argument& input,
+                 const argument& weights,
+                 const std::vector<std::size_t>& padding,
+                 const std::vector<std::size_t>& stride,
+                 const std::vector<std::size_t>& dilation,
+                 std::size_t group);
+
+} // namespace ref
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
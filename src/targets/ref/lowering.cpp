@@ -44,6 +44,7 @@
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/par_dfor.hpp>
 #include <migraphx/clamp.hpp>
+#include <migraphx/ref/convolution.hpp>
 #include <migraphx/ref/gemm.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/make_op.hpp>
@@ -117,21 +118,6 @@ struct ref_lrn
 };
 MIGRAPHX_REGISTER_OP(ref_lrn)
 
-template <class V, class T, class... Ts>
-void visit_quantize_impl(V&& v, T&& x, Ts&&... xs)
-{
-    x.visit([&](auto y) { visit_all(xs...)([&](auto... ys) { v(y, ys...); }); });
-}
-
-template <class T, class... Ts>
-auto visit_quantize(T&& x, Ts&&... xs)
-{
-    return [&](auto v) {
-        // Workaround for https://gcc.gnu.org/bugzilla/show_bug.cgi?id=70100
-        visit_quantize_impl(v, x, xs...);
-    };
-}
-
 template <class Op>
 struct ref_convolution : auto_register_op<ref_convolution<Op>>
 {
@@ -152,6 +138,7 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
     {
         return op.normalize_compute_shape(inputs);
     }
+    std::size_t flops(const std::vector<shape>& inputs) const { return op.flops(inputs); }
 
     argument compute(context&, shape output_shape, std::vector<argument> args) const
     {
@@ -178,59 +165,7 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
         }
 
         argument result{output_shape};
-        visit_quantize(result, args[0], args[1])([&](auto output, auto input, auto weights) {
-            auto in_lens = input.get_shape().lens();
-
-            auto wei_lens = weights.get_shape().lens();
-            auto wei_n    = wei_lens[0];
-            auto wei_c    = wei_lens[1];
-            std::vector<std::size_t> win_size(wei_lens.begin() + 1, wei_lens.end());
-
-            par_for(output_shape.elements(), [&](auto i) {
-                auto idx_o = output_shape.multi(i);
-                auto w     = idx_o[1];
-                auto n_dim = idx_o.size();
-
-                std::vector<std::ptrdiff_t> win_start;
-                for(std::size_t dim = 2; dim < n_dim; ++dim)
-                {
-                    auto d_2 = dim - 2;
-                    win_start.push_back(std::ptrdiff_t(idx_o[dim] * op.stride[d_2]) -
-                                        std::ptrdiff_t(padding[d_2]));
-                }
-                const auto group_id = w / (wei_n / op.group);
-
-                shape win_shape{output_shape.type(), win_size};
-
-                double acc = 0.0;
-                shape_for_each(win_shape, [&](auto idx_win) {
-                    auto k           = idx_win[0];
-                    const auto in_ch = group_id * wei_c + k;
-                    std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
-                    idx[1] = in_ch;
-                    std::transform(idx_win.begin() + 1,
-                                   idx_win.end(),
-                                   win_start.begin(),
-                                   idx.begin() + 2,
-                                   [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
-                    std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
-                    idx_wei[0] = w;
-                    std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
-                    if(std::all_of(idx.begin() + 2, idx.end(), [&](auto ii) { return ii >= 0; }) and
-                       std::equal(idx.begin(),
-                                  idx.end(),
-                                  in_lens.begin(),
-                                  in_lens.end(),
-                                  std::less<std::ptrdiff_t>{}))
-                    {
-                        acc +=
-                            input(idx.begin(), idx.end()) * weights(idx_wei.begin(), idx_wei.end());
-                    }
-                });
-
-                output[i] = acc;
-            });
-        });
+        convolution(result, args[0], args[1], padding, op.stride, op.dilation, op.group);
         return result;
     }
 };
@@ -311,6 +246,8 @@ struct ref_op
     }
     std::string name() const { return "ref::op"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    std::size_t flops(const std::vector<shape>& inputs) const { return op.flops(inputs); }
+    std::size_t bytes(const std::vector<shape>& inputs) const { return op.bytes(inputs); }
     argument compute(context&, const shape& output_shape, const std::vector<argument>& args) const
     {
         return op.compute(output_shape, args);
@@ -356,14 +293,13 @@ struct ref_pad
         });
 
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
-                std::transform(
-                    idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
-                        return i + j;
-                    });
-                output(new_idx.begin(), new_idx.end()) = input(idx.begin(), idx.end());
-            });
+            // View the interior of the output with the input's lens
+            const auto& out_s = output.get_shape();
+            shape window{out_s.type(), input.get_shape().lens(), out_s.strides()};
+            auto* start = output.data() + out_s.index(std::vector<std::size_t>(
+                                              op.pads.begin(), op.pads.begin() + out_s.ndim()));
+            shape_for_each_offset(window, input.get_shape())(
+                [&](auto i, auto j) { start[i] = input.data()[j]; });
         });
 
         return result;
@@ -382,6 +318,7 @@ struct ref_gemm
     }
     std::string name() const { return "ref::dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    std::size_t flops(const std::vector<shape>& inputs) const { return op.flops(inputs); }
 
     argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
     {
@@ -405,25 +342,15 @@ struct ref_quant_gemm
 
     std::string name() const { return "ref::quant_dot"; }
     shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    std::size_t flops(const std::vector<shape>& inputs) const { return op.flops(inputs); }
 
     argument compute(context&, const shape& output_shape, std::vector<argument> args) const
     {
         argument result{output_shape};
-        // first, convert the args[0] and args[1] from int8_t to int32_t
-        argument arg_0{{shape::int32_type, {args.at(0).get_shape().lens()}}};
-        argument arg_1{{shape::int32_type, {args.at(1).get_shape().lens()}}};
-        arg_0.visit([&](auto output) {
-            args.at(0).visit(
-                [&](auto input) { std::copy(input.begin(), input.end(), output.begin()); });
-        });
-
-        arg_1.visit([&](auto output) {
-            args.at(1).visit(
-                [&](auto input) { std::copy(input.begin(), input.end(), output.begin()); });
+        // The int8 inputs are widened to int32 while they are packed by gemm
+        visit_all(args.at(0), args.at(1))([&](auto amat, auto bmat) {
+            gemm(result.get<int32_t>(), amat, bmat, int32_t{1}, int32_t{0});
         });
-
-        migemm(result, arg_0, arg_1, int32_t{1}, int32_t{0});
-
         return result;
     }
 };
@@ -449,6 +376,7 @@ struct ref_softmax : auto_register_op<ref_softmax<Op>>
     {
         return op.normalize_compute_shape(inputs);
     }
+    std::size_t flops(const std::vector<shape>& inputs) const { return op.flops(inputs); }
     argument compute(context&, const dyn_output& dyn_out, std::vector<argument> args) const
     {
         argument result{dyn_out.computed_shape};
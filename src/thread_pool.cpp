@@ -0,0 +1,208 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_NUM_THREADS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_THREAD_AFFINITY)
+
+struct thread_pool_job
+{
+    const std::function<void(std::size_t)>* f = nullptr;
+    std::size_t n                             = 0;
+    std::atomic<std::size_t> next{0};
+    std::size_t finished = 0;
+    std::exception_ptr error;
+    std::mutex m;
+    std::condition_variable cv;
+
+    bool exhausted() const { return next >= n; }
+
+    // Claim tids until there are none left
+    void run()
+    {
+        for(std::size_t tid = next++; tid < n; tid = next++)
+        {
+            std::exception_ptr e;
+            try
+            {
+                (*f)(tid);
+            }
+            catch(...)
+            {
+                e = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(m);
+            if(e and not error)
+                error = e;
+            finished++;
+            if(finished == n)
+                cv.notify_all();
+        }
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return finished == n; });
+        if(error)
+            std::rethrow_exception(error);
+    }
+};
+
+struct thread_pool_impl
+{
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<thread_pool_job>> jobs;
+    std::mutex m;
+    std::condition_variable cv;
+    bool stop = false;
+
+    void work()
+    {
+        for(;;)
+        {
+            std::shared_ptr<thread_pool_job> job;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return stop or not jobs.empty(); });
+                if(stop)
+                    return;
+                job = jobs.front();
+                // Every tid of the job has been claimed, so there is nothing left to help with
+                if(job->exhausted())
+                {
+                    jobs.pop_front();
+                    continue;
+                }
+            }
+            job->run();
+        }
+    }
+};
+
+// The cpus the process is allowed to run on
+static std::vector<int> allowed_cpus()
+{
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if(sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) != 0)
+        return {};
+    std::vector<int> result;
+    for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if(CPU_ISSET(cpu, &cpuset))
+            result.push_back(cpu);
+    }
+    return result;
+}
+
+static bool set_affinity(std::thread& t, int cpu)
+{
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+}
+
+thread_pool::thread_pool(std::size_t nthreads, bool affinity)
+    : impl(std::make_unique<thread_pool_impl>())
+{
+    // The thread submitting a job also runs it, so one less worker is needed
+    auto nworkers = std::max<std::size_t>(nthreads, 1) - 1;
+    // Workers are pinned to the cpus of the process after the first one, which
+    // is left to the caller. When there are fewer cpus than threads, pinning
+    // would put several workers on one cpu, so none of them are pinned.
+    std::vector<int> cpus;
+    if(affinity)
+        cpus = allowed_cpus();
+    affinity = affinity and cpus.size() > nworkers;
+    impl->workers.reserve(nworkers);
+    for(std::size_t i = 0; i < nworkers; i++)
+    {
+        impl->workers.emplace_back([this] { impl->work(); });
+        // A worker that can't be pinned keeps the cpus of the process, and so
+        // do the ones after it
+        if(affinity)
+            affinity = set_affinity(impl->workers.back(), cpus[i + 1]);
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->stop = true;
+    }
+    impl->cv.notify_all();
+    for(auto& t : impl->workers)
+        t.join();
+}
+
+thread_pool& thread_pool::get()
+{
+    static thread_pool pool{value_of(MIGRAPHX_NUM_THREADS{}, std::thread::hardware_concurrency()),
+                            enabled(MIGRAPHX_THREAD_AFFINITY{})};
+    return pool;
+}
+
+std::size_t thread_pool::size() const { return impl->workers.size() + 1; }
+
+void thread_pool::parallel(std::size_t n, const std::function<void(std::size_t)>& f)
+{
+    if(n == 0)
+        return;
+    if(n == 1 or impl->workers.empty())
+    {
+        for(std::size_t tid = 0; tid < n; tid++)
+            f(tid);
+        return;
+    }
+    auto job = std::make_shared<thread_pool_job>();
+    job->f   = &f;
+    job->n   = n;
+    {
+        std::lock_guard<std::mutex> lock(impl->m);
+        impl->jobs.push_back(job);
+    }
+    impl->cv.notify_all();
+    job->run();
+    job->wait();
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -222,4 +222,31 @@ TEST_CASE(argument_share)
     EXPECT(a4.data() == a3.data());
 }
 
+TEST_CASE(argument_allocator_scope)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    std::vector<char> buffer(s.bytes());
+    std::size_t allocations = 0;
+    {
+        migraphx::argument_allocator_scope scope{[&](std::size_t n) {
+            allocations++;
+            EXPECT(n == buffer.size());
+            return std::shared_ptr<char>(buffer.data(), [](char*) {});
+        }};
+        migraphx::argument a{s};
+        EXPECT(a.data() == buffer.data());
+        {
+            migraphx::argument_allocator_scope inner{
+                [&](std::size_t n) { return migraphx::make_shared_array<char>(n); }};
+            migraphx::argument b{s};
+            EXPECT(b.data() != buffer.data());
+        }
+        migraphx::argument c{s};
+        EXPECT(c.data() == buffer.data());
+    }
+    migraphx::argument d{s};
+    EXPECT(d.data() != buffer.data());
+    EXPECT(allocations == 2);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
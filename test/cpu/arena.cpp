@@ -0,0 +1,181 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/arena.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+TEST_CASE(arena_zero_initialized)
+{
+    migraphx::cpu::arena a;
+    a.reset();
+    {
+        auto x = a.allocate(16);
+        std::fill(x.get(), x.get() + 16, 1);
+    }
+    a.reset();
+    auto y = a.allocate(16);
+    EXPECT(std::all_of(y.get(), y.get() + 16, [](char c) { return c == 0; }));
+}
+
+TEST_CASE(arena_reuse)
+{
+    migraphx::cpu::arena a;
+    // Nothing fits the first time, so the block grows at the next reset
+    a.reset();
+    a.allocate(100);
+    EXPECT(a.capacity() == 0);
+    std::vector<const char*> buffers;
+    for(int i = 0; i < 3; i++)
+    {
+        a.reset();
+        buffers.push_back(a.allocate(100).get());
+    }
+    EXPECT(a.capacity() == 128);
+    EXPECT(buffers[0] == buffers[1]);
+    EXPECT(buffers[1] == buffers[2]);
+}
+
+TEST_CASE(arena_high_water)
+{
+    migraphx::cpu::arena a;
+    a.reset();
+    {
+        // Buffers in use at the same time are summed
+        auto x = a.allocate(100);
+        auto y = a.allocate(200);
+    }
+    a.reset();
+    EXPECT(a.capacity() == 128 + 256);
+    auto x = a.allocate(100);
+    auto y = a.allocate(200);
+    EXPECT(y.get() - x.get() == 128);
+    // A smaller evaluation keeps the block
+    a.reset();
+    a.allocate(10);
+    a.reset();
+    EXPECT(a.capacity() == 128 + 256);
+}
+
+TEST_CASE(arena_reset_in_use)
+{
+    migraphx::cpu::arena a;
+    a.reset();
+    a.allocate(64);
+    a.reset();
+    // A buffer from another stream can still be in use when the next
+    // evaluation starts
+    auto x = a.allocate(64);
+    std::fill(x.get(), x.get() + 64, 1);
+    a.reset();
+    auto y = a.allocate(64);
+    EXPECT(x.get() != y.get());
+    EXPECT(std::all_of(x.get(), x.get() + 64, [](char c) { return c == 1; }));
+}
+
+// Computes its result through a temporary twice its size, which comes from
+// the arena when the operator runs through cpu::op
+struct temp_op : migraphx::auto_register_op<temp_op>
+{
+    static std::vector<const char*>& temporaries()
+    {
+        static std::vector<const char*> result;
+        return result;
+    }
+
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return migraphx::pack();
+    }
+
+    std::string name() const { return "temp_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front();
+    }
+    migraphx::argument compute(const migraphx::shape& output_shape,
+                               const std::vector<migraphx::argument>& args) const
+    {
+        const auto& x = args.front();
+        migraphx::argument tmp{{output_shape.type(), {2 * output_shape.elements()}}};
+        temporaries().push_back(tmp.data());
+        migraphx::argument result{output_shape};
+        visit_all(result, x, tmp)([&](auto output, auto input, auto t) {
+            std::transform(input.begin(), input.end(), t.begin(), [](auto v) { return v * 2; });
+            std::copy(t.begin(), t.begin() + output.size(), output.begin());
+        });
+        return result;
+    }
+};
+
+TEST_CASE(fallback_arena)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x = mm->add_parameter("x", s);
+    auto t = mm->add_instruction(temp_op{}, x);
+    mm->add_instruction(migraphx::make_op("relu"), t);
+    p.compile(migraphx::make_target("cpu"));
+
+    mm = p.get_main_module();
+    auto fallback = std::find_if(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "cpu::op"; });
+    EXPECT(std::distance(fallback, mm->end()) > 0);
+    // The output of the operator is planned with the other buffers
+    EXPECT(fallback->inputs().back()->name() == "load");
+    EXPECT(mm->begin()->name() == "cpu::reset_arena");
+
+    migraphx::parameter_map m;
+    m["x"] = migraphx::generate_argument(s);
+    std::vector<float> gold;
+    m["x"].visit([&](auto input) { gold.assign(input.begin(), input.end()); });
+    std::transform(
+        gold.begin(), gold.end(), gold.begin(), [](float v) { return std::max(v * 2, 0.0f); });
+    temp_op::temporaries().clear();
+    for(int i = 0; i < 3; i++)
+    {
+        std::vector<float> result;
+        p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+        EXPECT(migraphx::verify_range(result, gold));
+    }
+    // The temporaries of the later evaluations are in the same place in the
+    // block, which grew to fit them
+    const auto& temporaries = temp_op::temporaries();
+    EXPECT(temporaries.size() == 3);
+    EXPECT(temporaries[1] == temporaries[2]);
+    auto& ctx = migraphx::any_cast<migraphx::cpu::context>(p.get_context());
+    EXPECT(ctx.get_arena().capacity() >= 2 * s.bytes());
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,115 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+static migraphx::program create_pointwise(migraphx::shape::type_t t)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{t, {2, 3, 4}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto two = mm->add_literal(migraphx::literal{migraphx::shape{t}, {2}});
+    auto mb =
+        mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), two);
+    auto add  = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto mul  = mm->add_instruction(migraphx::make_op("mul"), add, mb);
+    auto relu = mm->add_instruction(migraphx::make_op("relu"), mul);
+    mm->add_return({relu});
+    return p;
+}
+
+static migraphx::program compile(migraphx::program p, const std::string& target)
+{
+    p.compile(migraphx::make_target(target));
+    return p;
+}
+
+static std::vector<double> run(const migraphx::program& p)
+{
+    migraphx::parameter_map m;
+    for(auto&& x : p.get_parameter_shapes())
+    {
+        if(x.first == "scratch")
+            continue;
+        m[x.first] = migraphx::generate_argument(x.second, x.first.front());
+    }
+    auto p2 = p;
+    std::vector<double> result;
+    p2.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static std::size_t count(const migraphx::program& p, const std::string& name)
+{
+    const auto* mm = p.get_main_module();
+    return std::count_if(
+        mm->begin(), mm->end(), [&](const auto& ins) { return ins.name() == name; });
+}
+
+TEST_CASE(pointwise_codegen)
+{
+    auto p = create_pointwise(migraphx::shape::float_type);
+    auto c = compile(p, "cpu");
+    EXPECT(count(c, "cpu::code_object") == 1);
+    EXPECT(count(c, "pointwise") == 0);
+    EXPECT(migraphx::verify_range(run(c), run(compile(p, "ref"))));
+}
+
+TEST_CASE(pointwise_half_fallback)
+{
+    auto p = create_pointwise(migraphx::shape::half_type);
+    auto c = compile(p, "cpu");
+    // Half is not a host type, so the module is inlined back for lowering
+    EXPECT(count(c, "cpu::code_object") == 0);
+    EXPECT(count(c, "pointwise") == 0);
+    EXPECT(migraphx::verify_range(run(c), run(compile(p, "ref"))));
+}
+
+TEST_CASE(pointwise_rebuild_host)
+{
+    auto p   = create_pointwise(migraphx::shape::float_type);
+    auto c   = compile(p, "cpu");
+    EXPECT(count(c, "cpu::code_object") == 1);
+    auto* mm = c.get_main_module();
+    auto ins = std::find_if(
+        mm->begin(), mm->end(), [](const auto& i) { return i.name() == "cpu::code_object"; });
+    // A code object built on another host is rebuilt from its source
+    auto v           = ins->get_operator().to_value();
+    v["host"]        = "other";
+    v["code_object"] = migraphx::value::binary{};
+    mm->replace_instruction(ins, migraphx::make_op("cpu::code_object", v), ins->inputs());
+    c.finalize();
+    EXPECT(migraphx::verify_range(run(c), run(compile(p, "ref"))));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
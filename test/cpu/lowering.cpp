@@ -0,0 +1,153 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+static migraphx::program create_dot(migraphx::shape::type_t t, const std::string& name = "dot")
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", migraphx::shape{t, {4, 8}});
+    auto b   = mm->add_parameter("b", migraphx::shape{t, {8, 6}});
+    mm->add_instruction(migraphx::make_op(name), a, b);
+    return p;
+}
+
+static migraphx::program create_convolution(migraphx::shape::type_t t,
+                                            const std::string& name = "convolution")
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", migraphx::shape{t, {1, 3, 8, 8}});
+    auto w   = mm->add_parameter("w", migraphx::shape{t, {4, 3, 3, 3}});
+    mm->add_instruction(migraphx::make_op(name), x, w);
+    return p;
+}
+
+static migraphx::program compile(migraphx::program p, const std::string& target)
+{
+    p.compile(migraphx::make_target(target));
+    return p;
+}
+
+// Filling the inputs with a value keeps small integer types from overflowing
+static std::vector<double> run(const migraphx::program& p, int fill = -1)
+{
+    migraphx::parameter_map m;
+    for(auto&& x : p.get_parameter_shapes())
+    {
+        if(x.first == "scratch")
+            continue;
+        m[x.first] = fill < 0 ? migraphx::generate_argument(x.second, x.first.front())
+                              : migraphx::fill_argument(x.second, fill);
+    }
+    auto p2 = p;
+    std::vector<double> result;
+    p2.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static std::size_t count(const migraphx::program& p, const std::string& name)
+{
+    const auto* mm = p.get_main_module();
+    return std::count_if(
+        mm->begin(), mm->end(), [&](const auto& ins) { return ins.name() == name; });
+}
+
+// Converts that are not run through cpu::op were never lowered
+static std::size_t count_converts(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::count_if(mm->begin(), mm->end(), [&](const auto& ins) {
+        if(ins.name() != "cpu::op")
+            return false;
+        return ins.get_operator().to_value()["name"].template to<std::string>() == "convert";
+    });
+}
+
+TEST_CASE(lower_half_dot)
+{
+    auto p = create_dot(migraphx::shape::half_type);
+    auto c = compile(p, "cpu");
+    EXPECT(count(c, "dnnl::dot") == 1);
+    EXPECT(count(c, "convert") == 0);
+    EXPECT(migraphx::verify_range(run(c), run(compile(p, "ref"))));
+}
+
+TEST_CASE(lower_half_convolution)
+{
+    auto p = create_convolution(migraphx::shape::half_type);
+    auto c = compile(p, "cpu");
+    EXPECT(count(c, "dnnl::convolution") == 1);
+    EXPECT(count(c, "convert") == 0);
+    EXPECT(migraphx::verify_range(run(c), run(compile(p, "ref"))));
+}
+
+TEST_CASE(lower_int8_dot)
+{
+    auto p = create_dot(migraphx::shape::int8_type);
+    auto c = compile(p, "cpu");
+    EXPECT(count(c, "dnnl::dot") == 1);
+    EXPECT(count(c, "convert") == 0);
+    EXPECT(run(c) == run(compile(p, "ref")));
+}
+
+TEST_CASE(lower_quant_dot)
+{
+    auto p = create_dot(migraphx::shape::int8_type, "quant_dot");
+    auto c = compile(p, "cpu");
+    // dnnl has int8 kernels that accumulate in int32, so no converts are needed
+    EXPECT(count(c, "dnnl::quant_dot") == 1);
+    EXPECT(count_converts(c) == 0);
+    EXPECT(run(c) == run(compile(p, "ref")));
+}
+
+TEST_CASE(lower_quant_convolution)
+{
+    auto p = create_convolution(migraphx::shape::int8_type, "quant_convolution");
+    auto c = compile(p, "cpu");
+    EXPECT(count(c, "dnnl::quant_convolution") == 1);
+    EXPECT(count_converts(c) == 0);
+    EXPECT(run(c) == run(compile(p, "ref")));
+}
+
+TEST_CASE(lower_convert_fallback)
+{
+    // dnnl has no uint8 convolution, so it is computed in float
+    auto p = create_convolution(migraphx::shape::uint8_type);
+    auto c = compile(p, "cpu");
+    EXPECT(count(c, "dnnl::convolution") == 1);
+    EXPECT(count(c, "convert") == 0);
+    EXPECT(count_converts(c) == 3);
+    EXPECT(run(c, 2) == run(compile(p, "ref"), 2));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,112 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <algorithm>
+#include <test.hpp>
+
+// The weights are either a literal, which is prepacked, or a parameter with
+// the same values, which is used in its plain layout
+static migraphx::program create_program(const migraphx::operation& op,
+                                        const migraphx::shape& xs,
+                                        const migraphx::shape& ws,
+                                        bool literal)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", xs);
+    auto w   = literal ? mm->add_literal(migraphx::generate_literal(ws, 1))
+                       : mm->add_parameter("w", ws);
+    mm->add_instruction(op, x, w);
+    return p;
+}
+
+static bool is_prepacked(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::any_of(mm->begin(), mm->end(), [](const auto& ins) {
+        auto v = ins.get_operator().to_value();
+        return v.contains("prepack_weights") and v.at("prepack_weights").template to<bool>();
+    });
+}
+
+static std::vector<float> run(migraphx::program p, const migraphx::shape& ws)
+{
+    p.compile(migraphx::make_target("cpu"));
+    migraphx::parameter_map m;
+    m["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), 0);
+    m["w"] = migraphx::generate_argument(ws, 1);
+    std::vector<float> result;
+    // The weights are packed on the first run and reused on the next
+    for(int i = 0; i < 2; i++)
+        p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+static void check_prepacked(const migraphx::operation& op,
+                            const migraphx::shape& xs,
+                            const migraphx::shape& ws)
+{
+    auto packed = create_program(op, xs, ws, true);
+    auto plain  = create_program(op, xs, ws, false);
+    auto c      = packed;
+    c.compile(migraphx::make_target("cpu"));
+    EXPECT(is_prepacked(c));
+    EXPECT(migraphx::verify_range(run(packed, ws), run(plain, ws)));
+}
+
+TEST_CASE(prepack_convolution)
+{
+    check_prepacked(migraphx::make_op("convolution", {{"padding", {1, 1}}}),
+                    {migraphx::shape::float_type, {2, 8, 14, 14}},
+                    {migraphx::shape::float_type, {16, 8, 3, 3}});
+}
+
+TEST_CASE(prepack_group_convolution)
+{
+    check_prepacked(migraphx::make_op("convolution", {{"group", 4}}),
+                    {migraphx::shape::float_type, {2, 16, 14, 14}},
+                    {migraphx::shape::float_type, {16, 4, 3, 3}});
+}
+
+TEST_CASE(prepack_deconvolution)
+{
+    check_prepacked(migraphx::make_op("deconvolution", {{"stride", {2, 2}}}),
+                    {migraphx::shape::float_type, {2, 8, 7, 7}},
+                    {migraphx::shape::float_type, {8, 16, 3, 3}});
+}
+
+TEST_CASE(prepack_dot)
+{
+    check_prepacked(migraphx::make_op("dot"),
+                    {migraphx::shape::float_type, {32, 64}},
+                    {migraphx::shape::float_type, {64, 48}});
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
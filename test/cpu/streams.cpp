@@ -0,0 +1,189 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/cpu/target.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <algorithm>
+#include <thread>
+#include <test.hpp>
+
+// The cpu target with its context set to several streams
+struct streams_target : migraphx::cpu::target
+{
+    std::size_t streams = 4;
+    migraphx::context get_context() const { return migraphx::cpu::context{streams}; }
+};
+
+struct throw_op
+{
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return migraphx::pack();
+    }
+
+    std::string name() const { return "throw_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front();
+    }
+    migraphx::argument compute(const migraphx::shape&, const std::vector<migraphx::argument>&) const
+    {
+        MIGRAPHX_THROW("throw_op");
+    }
+};
+
+// Independent dots, so they are scheduled on several streams
+static migraphx::program create_branches(std::size_t n, bool transpose_output)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape xs{migraphx::shape::float_type, {64, 64}};
+    auto x = mm->add_parameter("x", xs);
+    std::vector<migraphx::instruction_ref> branches;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto w = mm->add_literal(migraphx::generate_literal(xs, i));
+        auto d = mm->add_instruction(migraphx::make_op("dot"), x, w);
+        branches.push_back(mm->add_instruction(migraphx::make_op("relu"), d));
+    }
+    std::vector<migraphx::instruction_ref> outputs;
+    // One branch is only returned through a view of it
+    if(transpose_output)
+        outputs.push_back(mm->add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {1, 0}}}), branches.back()));
+    auto sum = branches.front();
+    for(std::size_t i = 1; i < n; i++)
+        sum = mm->add_instruction(migraphx::make_op("add"), sum, branches[i]);
+    outputs.push_back(sum);
+    mm->add_return(outputs);
+    return p;
+}
+
+static std::vector<std::vector<float>> run(migraphx::program p, const migraphx::target& t)
+{
+    p.compile(t);
+    migraphx::parameter_map m;
+    m["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), 7);
+    std::vector<std::vector<float>> results;
+    // Run several times so the streams of one run overlap with the next
+    for(int i = 0; i < 8; i++)
+    {
+        results.clear();
+        for(const auto& r : p.eval(m))
+        {
+            std::vector<float> v;
+            r.visit([&](auto output) { v.assign(output.begin(), output.end()); });
+            results.push_back(v);
+        }
+    }
+    return results;
+}
+
+static bool has_stream_ops(migraphx::program p, const migraphx::target& t)
+{
+    p.compile(t);
+    auto* mm = p.get_main_module();
+    return std::any_of(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "cpu::stream_op"; });
+}
+
+TEST_CASE(streams_branches)
+{
+    auto p = create_branches(4, false);
+    EXPECT(has_stream_ops(p, streams_target{}));
+    auto results = run(p, streams_target{});
+    auto gold    = run(p, migraphx::make_target("ref"));
+    EXPECT(results.size() == gold.size());
+    for(std::size_t i = 0; i < gold.size(); i++)
+        EXPECT(migraphx::verify_range(results[i], gold[i]));
+}
+
+TEST_CASE(streams_returned_view)
+{
+    auto p       = create_branches(4, true);
+    auto results = run(p, streams_target{});
+    auto gold    = run(p, migraphx::make_target("ref"));
+    EXPECT(results.size() == gold.size());
+    for(std::size_t i = 0; i < gold.size(); i++)
+        EXPECT(migraphx::verify_range(results[i], gold[i]));
+}
+
+TEST_CASE(streams_concurrent_eval)
+{
+    auto p    = create_branches(4, false);
+    auto gold = run(p, migraphx::make_target("ref"));
+    p.compile(streams_target{});
+    migraphx::parameter_map m;
+    m["x"] = migraphx::generate_argument(p.get_parameter_shape("x"), 7);
+    // Every thread but the first one runs with a fork of the context
+    std::vector<std::vector<std::vector<float>>> results(4);
+    std::vector<std::thread> threads;
+    for(auto& result : results)
+    {
+        threads.emplace_back([&] {
+            for(int i = 0; i < 8; i++)
+            {
+                result.clear();
+                for(const auto& r : p.eval(m))
+                {
+                    std::vector<float> v;
+                    r.visit([&](auto output) { v.assign(output.begin(), output.end()); });
+                    result.push_back(v);
+                }
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    for(const auto& result : results)
+    {
+        EXPECT(result.size() == gold.size());
+        for(std::size_t i = 0; i < gold.size(); i++)
+            EXPECT(migraphx::verify_range(result[i], gold[i]));
+    }
+}
+
+TEST_CASE(streams_error)
+{
+    auto p   = create_branches(4, false);
+    auto* mm = p.get_main_module();
+    // Make a branch throw, while its result is only used by another operator
+    auto relu = std::find_if(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "relu"; });
+    mm->replace_instruction(relu, throw_op{}, relu->inputs());
+    p.compile(streams_target{});
+    migraphx::parameter_map m;
+    m["x"] = migraphx::generate_argument(p.get_parameter_shape("x"));
+    // The error is thrown by the run that caused it, every time
+    for(int i = 0; i < 3; i++)
+        EXPECT(test::throws<migraphx::exception>([&] { p.eval(m); }, "throw_op"));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
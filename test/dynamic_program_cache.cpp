@@ -0,0 +1,140 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/dynamic_program_cache.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/verify.hpp>
+#include <test.hpp>
+
+static migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 8, 0}, {4, 4, 0}}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_instruction(migraphx::make_op("add"), x, x);
+    auto r   = mm->add_instruction(migraphx::make_op("relu"), y);
+    auto max = mm->add_instruction(migraphx::make_op("reduce_max", {{"axes", {1}}}), x);
+    mm->add_return({r, max});
+    return p;
+}
+
+static migraphx::parameter_map create_params(std::size_t batch)
+{
+    migraphx::shape s{migraphx::shape::float_type, {batch, 4}};
+    return {{"x", migraphx::generate_argument(s, batch)}};
+}
+
+static std::vector<std::vector<float>> to_vectors(const std::vector<migraphx::argument>& results)
+{
+    std::vector<std::vector<float>> v;
+    for(const auto& r : results)
+    {
+        v.emplace_back();
+        r.visit([&](auto output) { v.back().assign(output.begin(), output.end()); });
+    }
+    return v;
+}
+
+static std::vector<std::vector<float>> run_dynamic(const migraphx::parameter_map& params)
+{
+    auto p = create_program();
+    p.compile(migraphx::make_target("ref"));
+    return to_vectors(p.eval(params));
+}
+
+TEST_CASE(specialize_program)
+{
+    auto p = create_program();
+    migraphx::shape s{migraphx::shape::float_type, {3, 4}};
+    auto sp = migraphx::specialize_program(p, {{"x", s}});
+    EXPECT(sp.get_parameter_shape("x") == s);
+    EXPECT(sp.get_parameter_names() == p.get_parameter_names());
+    auto output_shapes = sp.get_output_shapes();
+    EXPECT(output_shapes.size() == 2);
+    EXPECT(output_shapes.front() == s);
+    EXPECT(output_shapes.back() == migraphx::shape{migraphx::shape::float_type, {3, 1}});
+    EXPECT(p.get_parameter_shape("x").dynamic());
+}
+
+TEST_CASE(specialize_program_dynamic_shape)
+{
+    auto p = create_program();
+    migraphx::shape s{migraphx::shape::float_type, {{1, 4, 0}, {4, 4, 0}}};
+    EXPECT(test::throws([&] { migraphx::specialize_program(p, {{"x", s}}); }));
+}
+
+TEST_CASE(cache_hits)
+{
+    migraphx::dynamic_program_cache cache{create_program(), migraphx::make_target("ref")};
+    for(std::size_t batch : {2, 3, 2, 3, 5})
+    {
+        auto params = create_params(batch);
+        auto result = to_vectors(cache.eval(params));
+        EXPECT(result == run_dynamic(params));
+    }
+    auto stats = cache.stats();
+    EXPECT(stats.hits == 2);
+    EXPECT(stats.misses == 3);
+    EXPECT(stats.compiled == 3);
+    EXPECT(cache.size() == 3);
+}
+
+TEST_CASE(cache_capacity)
+{
+    migraphx::dynamic_program_cache_options options;
+    options.capacity = 2;
+    migraphx::dynamic_program_cache cache{
+        create_program(), migraphx::make_target("ref"), {}, options};
+    for(std::size_t batch : {1, 2, 1, 3, 2})
+        cache.eval(create_params(batch));
+    // 2 was dropped when 3 was added, since 1 was used more recently
+    auto stats = cache.stats();
+    EXPECT(stats.hits == 1);
+    EXPECT(stats.misses == 4);
+    EXPECT(cache.size() == 2);
+}
+
+TEST_CASE(cache_buckets)
+{
+    migraphx::dynamic_program_cache_options options;
+    options.buckets = {8, 4};
+    migraphx::dynamic_program_cache cache{
+        create_program(), migraphx::make_target("ref"), {}, options};
+    for(std::size_t batch : {3, 4, 1, 6})
+    {
+        auto params  = create_params(batch);
+        auto results = cache.eval(params);
+        EXPECT(results.front().get_shape().lens() == std::vector<std::size_t>{batch, 4});
+        EXPECT(results.back().get_shape().lens() == std::vector<std::size_t>{batch, 1});
+        EXPECT(to_vectors(results) == run_dynamic(params));
+    }
+    auto stats = cache.stats();
+    EXPECT(stats.misses == 4);
+    EXPECT(stats.compiled == 2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -27,7 +27,10 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/compile_options.hpp>
+#include <atomic>
+#include <functional>
 #include <sstream>
+#include <thread>
 #include "test.hpp"
 #include <basic_ops.hpp>
 
@@ -498,6 +501,278 @@ TEST_CASE(eval_context3)
     EXPECT(not is_shared(t.ctx, p.get_context()));
 }
 
+TEST_CASE(eval_plan1)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::int32_type});
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, x, two);
+    mm->add_instruction(sum_op{}, sum, two);
+    EXPECT(not p.has_eval_plan());
+    p.compile(id_target{});
+    EXPECT(p.has_eval_plan());
+    auto result = p.eval({{"x", migraphx::literal{1}.get_argument()}}).back();
+    EXPECT(result == migraphx::literal{5});
+    EXPECT(test::throws<migraphx::exception>([&] { p.eval({}); }, "Parameter not found: x"));
+}
+
+TEST_CASE(eval_plan_copy)
+{
+    migraphx::program p1;
+    auto* mm = p1.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    mm->add_instruction(sum_op{}, one, two);
+    p1.compile(id_target{});
+    migraphx::program p2 = p1;
+    EXPECT(p2.has_eval_plan());
+    EXPECT(p2.eval({}).back() == migraphx::literal{3});
+}
+
+TEST_CASE(eval_plan_modified)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    mm->add_instruction(sum_op{}, sum, two);
+    EXPECT(not p.has_eval_plan());
+    EXPECT(p.eval({}).back() == migraphx::literal{5});
+}
+
+TEST_CASE(eval_plan_replaced)
+{
+    migraphx::program p;
+    auto* mm   = p.get_main_module();
+    auto one   = mm->add_literal(1);
+    auto two   = mm->add_literal(2);
+    auto sum   = mm->add_instruction(sum_op{}, one, two);
+    auto three = mm->add_literal(3);
+    mm->add_instruction(sum_op{}, sum, three);
+    p.compile(id_target{});
+    EXPECT(p.has_eval_plan());
+    // The size and the last instruction of the module are the same
+    mm->replace_instruction(sum, minus_op{}, two, one);
+    EXPECT(not p.has_eval_plan());
+    EXPECT(p.eval({}).back() == migraphx::literal{4});
+}
+
+struct fork_target
+{
+    struct context
+    {
+        std::shared_ptr<std::atomic<int>> forks = std::make_shared<std::atomic<int>>(0);
+        void finish() const {}
+        context fork() const
+        {
+            (*forks)++;
+            return *this;
+        }
+    };
+    context ctx{};
+    std::string name() const { return "fork"; }
+    std::vector<migraphx::pass> get_passes(migraphx::context&,
+                                           const migraphx::compile_options&) const
+    {
+        return {};
+    }
+    migraphx::context get_context() const { return ctx; }
+};
+
+struct scratch_op
+{
+    migraphx::shape s;
+    migraphx::argument data;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.s, "shape"));
+    }
+
+    std::string name() const { return "scratch"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const { return s; }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape&,
+                               const std::vector<migraphx::argument>&) const
+    {
+        return data;
+    }
+    void finalize(migraphx::context&, const migraphx::shape&, const std::vector<migraphx::shape>&)
+    {
+        data = migraphx::argument{s};
+    }
+    migraphx::lifetime get_lifetime() const { return migraphx::lifetime::global; }
+};
+
+struct copy_to_scratch_op
+{
+    // Called after the input is copied, before the scratch is returned
+    std::function<void()> f = nullptr;
+
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return migraphx::pack();
+    }
+
+    std::string name() const { return "copy_to_scratch"; }
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.at(1);
+    }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape&,
+                               std::vector<migraphx::argument> args) const
+    {
+        std::copy(args[0].data(), args[0].data() + args[0].get_shape().bytes(), args[1].data());
+        if(f)
+            f();
+        return args[1];
+    }
+    std::ptrdiff_t output_alias(const std::vector<migraphx::shape>&) const { return 1; }
+};
+
+TEST_CASE(eval_nested)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {4}};
+    auto x       = mm->add_parameter("x", s);
+    auto scratch = mm->add_instruction(scratch_op{s});
+    std::vector<int> data1 = {1, 2, 3, 4};
+    std::vector<int> data2 = {5, 6, 7, 8};
+    std::vector<int> nested_result;
+    copy_to_scratch_op op;
+    // Run the program again while the first run still uses its scratch
+    op.f = [&] {
+        if(not nested_result.empty())
+            return;
+        nested_result = {0};
+        auto result   = p.eval({{"x", migraphx::argument{s, data2.data()}}}).back();
+        result.visit([&](auto v) { nested_result.assign(v.begin(), v.end()); });
+    };
+    mm->add_instruction(op, x, scratch);
+    fork_target t{};
+    p.compile(t);
+
+    auto result = p.eval({{"x", migraphx::argument{s, data1.data()}}}).back();
+    std::vector<int> result_data;
+    result.visit([&](auto v) { result_data.assign(v.begin(), v.end()); });
+    EXPECT(result_data == data1);
+    EXPECT(nested_result == data2);
+    EXPECT(t.ctx.forks->load() == 1);
+}
+
+TEST_CASE(eval_threads)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {64}};
+    auto x       = mm->add_parameter("x", s);
+    auto scratch = mm->add_instruction(scratch_op{s});
+    copy_to_scratch_op op;
+    op.f = [] { std::this_thread::yield(); };
+    mm->add_instruction(op, x, scratch);
+    p.compile(fork_target{});
+
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&, i] {
+            std::vector<int> data(s.elements(), i);
+            for(int j = 0; j < 100; j++)
+            {
+                auto result = p.eval({{"x", migraphx::argument{s, data.data()}}}).back();
+                result.visit([&](auto v) {
+                    if(not std::equal(v.begin(), v.end(), data.begin()))
+                        failures++;
+                });
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+    EXPECT(failures.load() == 0);
+}
+
+TEST_CASE(eval_outputs_copied)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {4}};
+    auto x       = mm->add_parameter("x", s);
+    auto scratch = mm->add_instruction(scratch_op{s});
+    mm->add_instruction(copy_to_scratch_op{}, x, scratch);
+    p.compile(fork_target{});
+
+    std::vector<int> data = {1, 2, 3, 4};
+    migraphx::parameter_map params{{"x", migraphx::argument{s, data.data()}}};
+    // The thread that runs the program first gets the outputs in the scratch
+    auto result1 = p.eval(params).back();
+    auto result2 = p.eval(params).back();
+    EXPECT(result1.data() == result2.data());
+    // Other threads get copies of the scratch of their state
+    std::vector<migraphx::argument> other;
+    std::thread t{[&] {
+        for(int i = 0; i < 2; i++)
+            other.push_back(p.eval(params).back());
+    }};
+    t.join();
+    EXPECT(other.at(0).data() != result1.data());
+    EXPECT(other.at(0).data() != other.at(1).data());
+    EXPECT(other.at(1) == result1);
+}
+
+// Records the data of its input
+struct record_data_op
+{
+    std::shared_ptr<const char*> data = std::make_shared<const char*>(nullptr);
+
+    template <class Self, class F>
+    static auto reflect(Self&, F)
+    {
+        return migraphx::pack();
+    }
+
+    std::string name() const { return "record_data_op"; }
+    migraphx::argument compute(const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        *data = args.front().data();
+        return args.front();
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+    int output_alias(const std::vector<migraphx::shape>&) const { return 0; }
+};
+
+TEST_CASE(eval_literal_in_place)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::int32_type, {4}};
+    auto lit = mm->add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+    record_data_op op;
+    mm->add_instruction(op, lit);
+    p.compile(id_target{});
+    for(int i = 0; i < 2; i++)
+    {
+        auto result = p.eval({}).back();
+        // The literal is used without copying it, but the output that refers
+        // to it is a copy
+        EXPECT(*op.data == lit->get_literal().data());
+        EXPECT(result.data() != lit->get_literal().data());
+        EXPECT(result == lit->get_literal().get_argument());
+    }
+}
+
 struct cout_redirect
 {
     cout_redirect()                     = delete;
@@ -0,0 +1,63 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/file_buffer.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <test.hpp>
+
+TEST_CASE(map_file_data)
+{
+    std::string filename = "migraphx_map_file.bin";
+    std::vector<char> buffer(100);
+    std::iota(buffer.begin(), buffer.end(), 0);
+    migraphx::write_buffer(filename, buffer);
+    auto file = migraphx::map_file(filename);
+    std::remove(filename.c_str());
+    // The mapping stays valid after the file is removed
+    EXPECT(file.data != nullptr);
+    EXPECT(file.size == buffer.size());
+    EXPECT(std::equal(buffer.begin(), buffer.end(), file.data.get()));
+    // The mapping is private, so it can be written to
+    file.data.get()[0] = 1;
+    EXPECT(file.data.get()[0] == 1);
+}
+
+TEST_CASE(map_file_missing)
+{
+    auto file = migraphx::map_file("migraphx_map_file_missing.bin");
+    EXPECT(file.data == nullptr);
+    EXPECT(file.size == 0);
+}
+
+TEST_CASE(map_file_empty)
+{
+    std::string filename = "migraphx_map_file_empty.bin";
+    migraphx::write_buffer(filename, std::vector<char>{});
+    auto file = migraphx::map_file(filename);
+    std::remove(filename.c_str());
+    EXPECT(file.data == nullptr);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
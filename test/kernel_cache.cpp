@@ -0,0 +1,131 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/kernel_cache.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <test.hpp>
+#include <chrono>
+#include <fstream>
+
+TEST_CASE(put_get)
+{
+    migraphx::tmp_dir td{};
+    migraphx::kernel_cache cache{td.path / "kernels"};
+    EXPECT(cache.get("key").empty());
+    std::vector<char> data = {'a', 'b', 'c'};
+    cache.put("key", data);
+    EXPECT(cache.get("key") == data);
+    EXPECT(cache.get("other").empty());
+}
+
+TEST_CASE(get_or_compile)
+{
+    migraphx::tmp_dir td{};
+    migraphx::kernel_cache cache{td.path};
+    std::size_t compiled = 0;
+    auto compile         = [&] {
+        compiled++;
+        return std::vector<char>{'x'};
+    };
+    auto before = migraphx::get_kernel_cache_stats();
+    EXPECT(cache.get_or_compile("key", compile) == std::vector<char>{'x'});
+    EXPECT(cache.get_or_compile("key", compile) == std::vector<char>{'x'});
+    auto after = migraphx::get_kernel_cache_stats();
+    EXPECT(compiled == 1);
+    EXPECT(after.hits - before.hits == 1);
+    EXPECT(after.misses - before.misses == 1);
+}
+
+TEST_CASE(evict)
+{
+    migraphx::tmp_dir td{};
+    migraphx::kernel_cache cache{td.path, 64};
+    auto entry = [](char c) { return std::vector<char>(24, c); };
+    cache.put("a", entry('a'));
+    cache.put("b", entry('b'));
+    // Reading an entry makes it the most recently used
+    auto t = migraphx::fs::file_time_type::clock::now() - std::chrono::hours{1};
+    for(const auto& e : migraphx::fs::directory_iterator(td.path))
+        migraphx::fs::last_write_time(e.path(), t);
+    EXPECT(cache.get("a") == entry('a'));
+    cache.put("c", entry('c'));
+    EXPECT(cache.get("a") == entry('a'));
+    EXPECT(cache.get("b").empty());
+    EXPECT(cache.get("c") == entry('c'));
+}
+
+static std::vector<migraphx::fs::path> list_files(const migraphx::fs::path& path)
+{
+    std::vector<migraphx::fs::path> files;
+    for(const auto& e : migraphx::fs::directory_iterator(path))
+        files.push_back(e.path());
+    return files;
+}
+
+TEST_CASE(unreadable_entry)
+{
+    migraphx::tmp_dir td{};
+    migraphx::kernel_cache cache{td.path};
+    cache.put("key", {'a', 'b', 'c'});
+    auto files = list_files(td.path);
+    // Only the entry is left once it is written
+    EXPECT(files.size() == 1);
+    EXPECT(files.front().extension() == ".bin");
+    // An empty entry is a miss
+    std::ofstream{files.front().string()};
+    EXPECT(cache.get("key").empty());
+    // So is an entry that can't be read
+    migraphx::fs::remove(files.front());
+    migraphx::fs::create_directory(files.front());
+    EXPECT(cache.get("key").empty());
+    std::size_t compiled = 0;
+    auto compile         = [&] {
+        compiled++;
+        return std::vector<char>{'x'};
+    };
+    EXPECT(cache.get_or_compile("key", compile) == std::vector<char>{'x'});
+    EXPECT(compiled == 1);
+}
+
+TEST_CASE(default_max_size)
+{
+    // The default cache is bounded, so evict keeps its directory from growing
+    auto cache = migraphx::get_kernel_cache();
+    EXPECT(not cache.enabled() or cache.max_size > 0);
+}
+
+TEST_CASE(disabled)
+{
+    migraphx::kernel_cache cache{};
+    EXPECT(not cache.enabled());
+    std::size_t compiled = 0;
+    auto compile         = [&] {
+        compiled++;
+        return std::vector<char>{'x'};
+    };
+    cache.get_or_compile("key", compile);
+    cache.get_or_compile("key", compile);
+    EXPECT(compiled == 2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -162,6 +162,19 @@ TEST_CASE(literal_visit_empty)
     EXPECT(test::throws([&] { x.visit_at([](auto) {}); }));
 }
 
+TEST_CASE(literal_argument)
+{
+    migraphx::shape s{migraphx::shape::int64_type, {3}};
+    migraphx::literal l{s, {1, 2, 3}};
+    auto a = l.get_argument();
+    // The argument refers to the data of the literal
+    EXPECT(a.data() == l.data());
+    EXPECT(a.get_shape() == s);
+    l = migraphx::literal{};
+    // and keeps it alive
+    EXPECT(a == migraphx::literal{s, {1, 2, 3}}.get_argument());
+}
+
 TEST_CASE(value_literal)
 {
     migraphx::shape s{migraphx::shape::int64_type, {3}};
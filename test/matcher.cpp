@@ -1086,4 +1086,61 @@ TEST_CASE(match_finder)
     match::find_matches(mm, match_find_sum{sum}, match_find_literal{sum});
 }
 
+TEST_CASE(match_root_names)
+{
+    using names = std::unordered_set<std::string>;
+    EXPECT(match::root_names(match::name("sum")) == names{"sum"});
+    EXPECT(match::root_names(match::name("sum", "minus")) == names{"sum", "minus"});
+    EXPECT(match::root_names(match::name("sum")(match::arg(0)(match::name("@literal"))).bind(
+               "x")) == names{"sum"});
+    EXPECT(match::root_names(match::any_of(match::name("sum"), match::name("minus"))) ==
+           names{"sum", "minus"});
+    EXPECT(match::root_names(match::all_of(match::standard_shape(), match::name("sum"))) ==
+           names{"sum"});
+    EXPECT(match::root_names(match::any_of(match::name("sum"), match::any())).empty());
+    EXPECT(match::root_names(match::none_of(match::name("sum"))).empty());
+    EXPECT(match::root_names(match::standard_shape()).empty());
+}
+
+struct match_sum_to_minus
+{
+    auto matcher() const
+    {
+        return match::name("sum")(match::any_of[match::outputs()](match::name("minus")));
+    }
+
+    void apply(migraphx::module& m, const match::matcher_result& r) const
+    {
+        m.replace_instruction(r.result, minus_op{}, r.result->inputs());
+    }
+};
+
+TEST_CASE(match_fixpoint)
+{
+    migraphx::module mm;
+    {
+        auto one  = mm.add_literal(1);
+        auto two  = mm.add_literal(2);
+        auto sum1 = mm.add_instruction(sum_op{}, one, two);
+        auto sum2 = mm.add_instruction(sum_op{}, sum1, two);
+        auto sum3 = mm.add_instruction(sum_op{}, sum2, two);
+        auto sub  = mm.add_instruction(minus_op{}, sum3, one);
+        mm.add_instruction(pass_op{}, sub);
+    }
+    auto hits = match::find_matches_fixpoint(mm, match_find_literal{mm.end()}, match_sum_to_minus{});
+    EXPECT(hits == std::vector<std::size_t>{0, 3});
+
+    migraphx::module expected;
+    {
+        auto one  = expected.add_literal(1);
+        auto two  = expected.add_literal(2);
+        auto sub1 = expected.add_instruction(minus_op{}, one, two);
+        auto sub2 = expected.add_instruction(minus_op{}, sub1, two);
+        auto sub3 = expected.add_instruction(minus_op{}, sub2, two);
+        auto sub  = expected.add_instruction(minus_op{}, sub3, one);
+        expected.add_instruction(pass_op{}, sub);
+    }
+    EXPECT(mm == expected);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -29,6 +29,7 @@ import onnx
 from onnx import helper
 from onnx import TensorProto
 from onnx.numpy_helper import from_array
+from onnx.external_data_helper import set_external_data
 
 
 def onnx_test(external_data=False):
@@ -1878,6 +1879,31 @@ def external_constant_test():
     return ([node], [], [y])
 
 
+@onnx_test()
+def external_data_offset_test():
+    # a starts the external file, so it can be mapped in place, while b is at
+    # an offset that is misaligned for float, so it has to be copied
+    a = np.arange(10, dtype=np.float32)
+    b = np.arange(10, 20, dtype=np.float32)
+    location = 'external_data_offset_test.weight'
+    with open(location, 'wb') as f:
+        f.write(a.tobytes())
+        f.write(b'\x00\x00')
+        f.write(b.tobytes())
+    tensors = []
+    for name, x, offset in [('a', a, 0), ('b', b, 42)]:
+        tensor = from_array(x, name)
+        set_external_data(tensor, location, offset, x.nbytes)
+        tensor.ClearField('raw_data')
+        tensor.data_location = TensorProto.EXTERNAL
+        tensors.append(tensor)
+
+    y = helper.make_tensor_value_info('y', TensorProto.FLOAT, [10])
+    node = onnx.helper.make_node('Add', inputs=['a', 'b'], outputs=['y'])
+
+    return ([node], [], [y], tensors)
+
+
 @onnx_test()
 def eyelike_default_test():
     T1 = helper.make_tensor_value_info('T1', TensorProto.FLOAT, [3, 4])
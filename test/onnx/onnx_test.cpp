@@ -21,8 +21,11 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
+#include <numeric>
 #include <vector>
 #include <random>
 #include <migraphx/common.hpp>
@@ -1882,6 +1885,46 @@ TEST_CASE(external_data_diff_path_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(external_data_offset_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {10}};
+    std::vector<float> a_data(10);
+    std::vector<float> b_data(10);
+    std::iota(a_data.begin(), a_data.end(), 0);
+    std::iota(b_data.begin(), b_data.end(), 10);
+    auto a = mm->add_literal(migraphx::literal{s, a_data});
+    auto b = mm->add_literal(migraphx::literal{s, b_data});
+    mm->add_instruction(migraphx::make_op("add"), a, b);
+
+    auto prog = optimize_onnx("external_data_offset_test.onnx");
+    EXPECT(p == prog);
+    auto* pm          = prog.get_main_module();
+    auto find_literal = [&](float first) -> const migraphx::literal& {
+        auto ins = std::find_if(pm->begin(), pm->end(), [&](const auto& i) {
+            return i.name() == "@literal" and i.get_literal().template at<float>() == first;
+        });
+        EXPECT(std::distance(ins, pm->end()) > 0);
+        return ins->get_literal();
+    };
+    auto address = [](const migraphx::literal& l) {
+        return reinterpret_cast<std::uintptr_t>(l.data());
+    };
+    // a is at the start of the file, so it is used in place from the mapping,
+    // which starts on a page
+    const auto& a_lit = find_literal(0);
+    EXPECT(address(a_lit) % 4096 == 0);
+    // b is 42 bytes into the file, which is misaligned for float, so it is
+    // copied into an aligned buffer rather than read from the mapping
+    const auto& b_lit = find_literal(10);
+    EXPECT(address(b_lit) % alignof(float) == 0);
+    EXPECT(address(b_lit) != address(a_lit) + 42);
+    std::vector<float> b_values;
+    b_lit.visit([&](auto v) { b_values.assign(v.begin(), v.end()); });
+    EXPECT(b_values == b_data);
+}
+
 TEST_CASE(eyelike_default_test)
 {
     migraphx::program p;
@@ -6549,6 +6592,17 @@ TEST_CASE(sum_type_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(sum_type_file_buffer_test)
+{
+    // Files are read with their initializers referring to the mapped file,
+    // which must give the same program as parsing the whole message
+    std::ifstream is("sum_type_test.onnx", std::ios::binary);
+    std::string buffer((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    auto p1 = migraphx::parse_onnx("sum_type_test.onnx");
+    auto p2 = migraphx::parse_onnx_buffer(buffer, migraphx::onnx_options{});
+    EXPECT(p1 == p2);
+}
+
 TEST_CASE(tan_test)
 {
     migraphx::program p;
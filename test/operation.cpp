@@ -270,4 +270,22 @@ TEST_CASE(compile_non_compilable)
     EXPECT(v.empty());
 }
 
+TEST_CASE(flops_default)
+{
+    migraphx::operation op = simple_operation{};
+    EXPECT(op.flops({migraphx::shape{migraphx::shape::float_type, {2, 3}}}) == 0);
+}
+
+TEST_CASE(bytes_default)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::operation op = compilable_op{};
+    // The output aliases the only input so it is a view
+    EXPECT(op.bytes({s}) == 0);
+    // The aliased input is not read
+    EXPECT(op.bytes({s, s}) == 2 * s.bytes());
+    migraphx::shape ds{migraphx::shape::float_type, {{1, 4}, {3, 3}}};
+    EXPECT(op.bytes({ds, ds}) == 0);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pass_telemetry.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/simplify_reshapes.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <test.hpp>
+
+static migraphx::module create_transposes()
+{
+    migraphx::module m;
+    auto x  = m.add_parameter("x", {migraphx::shape::float_type, {2, 3}});
+    auto t1 = m.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), x);
+    auto t2 = m.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), t1);
+    m.add_return({t2});
+    return m;
+}
+
+TEST_CASE(record_passes)
+{
+    auto m = create_transposes();
+    migraphx::pass_telemetry telemetry;
+    EXPECT(migraphx::pass_telemetry::current() == &telemetry);
+    migraphx::run_passes(m, {migraphx::simplify_reshapes{}, migraphx::dead_code_elimination{}});
+    const auto& records = telemetry.records();
+    EXPECT(records.size() == 2);
+    EXPECT(records[0].pass == "simplify_reshapes");
+    EXPECT(records[0].instructions_before == 4);
+    EXPECT(records[0].instructions_after == 2);
+    EXPECT(records[0].time >= 0);
+    EXPECT(records[0].matcher_hits.size() == 1);
+    EXPECT(records[0].matcher_hits.begin()->second == 1);
+    EXPECT(records[1].pass == "dead_code_elimination");
+    EXPECT(records[1].matcher_hits.empty());
+
+    auto v = migraphx::pass_records_to_value(records);
+    EXPECT(v.size() == 2);
+    EXPECT(v.at(0).at("pass").to<std::string>() == "simplify_reshapes");
+    EXPECT(v.at(0).at("instructions_after").to<std::size_t>() == 2);
+}
+
+TEST_CASE(nested_telemetry)
+{
+    auto m = create_transposes();
+    migraphx::pass_telemetry outer;
+    {
+        migraphx::pass_telemetry inner;
+        EXPECT(migraphx::pass_telemetry::current() == &inner);
+        migraphx::run_passes(m, {migraphx::dead_code_elimination{}});
+        EXPECT(inner.records().size() == 1);
+    }
+    EXPECT(migraphx::pass_telemetry::current() == &outer);
+    EXPECT(outer.records().empty());
+}
+
+TEST_CASE(no_telemetry)
+{
+    EXPECT(migraphx::pass_telemetry::current() == nullptr);
+    auto m = create_transposes();
+    migraphx::run_passes(m, {migraphx::simplify_reshapes{}});
+    EXPECT(m.size() == 2);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -25,6 +25,12 @@
 #include <migraphx/ranges.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/register_target.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/profile.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/op/common.hpp>
+#include <numeric>
+#include <thread>
 #include "test.hpp"
 
 TEST_CASE(perf_report)
@@ -50,4 +56,142 @@ TEST_CASE(perf_report)
     EXPECT(not migraphx::contains(output, "fast"));
 }
 
+TEST_CASE(profile)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape as{migraphx::shape::float_type, {2, 3}};
+    migraphx::shape bs{migraphx::shape::float_type, {3, 4}};
+    auto a   = mm->add_literal(migraphx::generate_literal(as));
+    auto b   = mm->add_literal(migraphx::generate_literal(bs));
+    auto dot = mm->add_instruction(migraphx::make_op("dot"), a, b);
+    mm->add_instruction(migraphx::make_op("relu"), dot);
+    p.compile(migraphx::make_target("ref"));
+
+    auto profiles = p.profile({}, 3, true);
+    EXPECT(profiles.size() == 4);
+    const auto& dot_profile = profiles.at(2);
+    EXPECT(migraphx::contains(dot_profile.ins->name(), "dot"));
+    EXPECT(dot_profile.flops == 2 * 2 * 4 * 3);
+    EXPECT(dot_profile.bytes_read == as.bytes() + bs.bytes());
+    EXPECT(dot_profile.bytes_written == 2 * 4 * sizeof(float));
+    EXPECT(profiles.front().bytes_read == 0);
+    EXPECT(profiles.back().flops == 2 * 4);
+
+    auto trace  = migraphx::profile_to_chrome_trace(profiles);
+    auto events = trace.at("traceEvents");
+    EXPECT(events.size() == profiles.size());
+    EXPECT(events.at(2).at("ph").to<std::string>() == "X");
+    EXPECT(events.at(2).at("args").at("flops").to<std::size_t>() == dot_profile.flops);
+    EXPECT(migraphx::profile_to_value(profiles).size() == profiles.size());
+
+    std::stringstream ss;
+    p.perf_report(ss, 3, {}, 1, profiles);
+    EXPECT(migraphx::contains(ss.str(), "GFLOP/s"));
+}
+
+TEST_CASE(profile_concurrent_eval)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto a   = mm->add_literal(migraphx::generate_literal(s));
+    auto b   = mm->add_literal(migraphx::generate_literal(s));
+    auto add = mm->add_instruction(migraphx::make_op("add"), a, b);
+    mm->add_instruction(migraphx::make_op("relu"), add);
+    p.compile(migraphx::make_target("ref"));
+    auto expected = p.eval({}).back();
+
+    // The profile runs on another thread than the one the context belongs to,
+    // while that one keeps calling eval
+    std::vector<migraphx::instruction_profile> profiles;
+    std::thread t([&] { profiles = p.profile({}, 8); });
+    for(int i = 0; i < 8; i++)
+        EXPECT(p.eval({}).back() == expected);
+    t.join();
+    EXPECT(profiles.size() == 4);
+    EXPECT(migraphx::contains(profiles.back().text, "relu"));
+}
+
+TEST_CASE(cost_model)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape xs{migraphx::shape::float_type, {1, 3, 8, 8}};
+    migraphx::shape ws{migraphx::shape::float_type, {4, 3, 3, 3}};
+    auto x    = mm->add_parameter("x", xs);
+    auto w    = mm->add_literal(migraphx::generate_literal(ws));
+    auto conv = mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}}), x, w);
+    auto pool = mm->add_instruction(migraphx::make_op("pooling",
+                                                      {{"mode", migraphx::op::pooling_mode::max},
+                                                       {"lengths", {2, 2}},
+                                                       {"stride", {2, 2}}}),
+                                    conv);
+    auto sum = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {2, 3}}}), pool);
+    mm->add_instruction(migraphx::make_op("softmax", {{"axis", 1}}), sum);
+    p.compile(migraphx::make_target("ref"));
+
+    auto costs = p.cost_model();
+    auto cost  = [&](const std::string& name) {
+        auto it = std::find_if(costs.begin(), costs.end(), [&](const auto& c) {
+            return migraphx::contains(c.group, name);
+        });
+        EXPECT(bool{it != costs.end()});
+        return *it;
+    };
+    auto conv_cost = cost("convolution");
+    EXPECT(conv_cost.instructions == 1);
+    EXPECT(conv_cost.flops == 2 * (4 * 8 * 8) * (3 * 3 * 3));
+    EXPECT(conv_cost.bytes == xs.bytes() + ws.bytes() + 4 * 8 * 8 * sizeof(float));
+    EXPECT(conv_cost.arithmetic_intensity() > 1);
+    EXPECT(cost("softmax").flops == 5 * 4);
+    // The ref target lowers pooling and reduce_sum to the same generic operator
+    auto total = std::accumulate(costs.begin(), costs.end(), std::size_t{0}, [](auto n, auto c) {
+        return n + c.flops;
+    });
+    EXPECT(total == conv_cost.flops + (4 * 4 * 4) * (2 * 2) + 4 * 4 * 4 + 5 * 4);
+    EXPECT(costs.front().flops == conv_cost.flops);
+
+    std::stringstream ss;
+    migraphx::print_cost_model(ss, costs);
+    EXPECT(migraphx::contains(ss.str(), "Total:"));
+}
+
+// Reads every other element of its input
+struct strided_read_op
+{
+    std::string name() const { return "strided_read"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front();
+    }
+    migraphx::argument compute(const migraphx::shape&, std::vector<migraphx::argument>) const
+    {
+        MIGRAPHX_THROW("not computable");
+    }
+    std::size_t bytes(const std::vector<migraphx::shape>& inputs) const
+    {
+        return inputs.front().bytes() / 2 + inputs.front().bytes();
+    }
+};
+
+TEST_CASE(estimate_bytes)
+{
+    migraphx::module m;
+    migraphx::shape s{migraphx::shape::float_type, {2, 4}};
+    auto x    = m.add_parameter("x", s);
+    auto read = m.add_instruction(strided_read_op{}, x);
+    auto add  = m.add_instruction(migraphx::make_op("add"), x, read);
+    auto tr   = m.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), add);
+    auto read_bytes = migraphx::estimate_bytes(read);
+    EXPECT(read_bytes.first == s.bytes() / 2);
+    EXPECT(read_bytes.second == s.bytes());
+    auto add_bytes = migraphx::estimate_bytes(add);
+    EXPECT(add_bytes.first == 2 * s.bytes());
+    EXPECT(add_bytes.second == s.bytes());
+    auto tr_bytes = migraphx::estimate_bytes(tr);
+    EXPECT(tr_bytes.first == 0);
+    EXPECT(tr_bytes.second == 0);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,131 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/program_cache.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <test.hpp>
+#include <algorithm>
+#include <cstdint>
+
+static migraphx::program create_program(float x = 1.0f)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto a   = mm->add_parameter("a", {migraphx::shape::float_type, {3}});
+    auto b   = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {3}}, {x, x, x}});
+    mm->add_instruction(migraphx::make_op("add"), a, b);
+    return p;
+}
+
+static std::vector<float> run(migraphx::program& p)
+{
+    std::vector<float> a = {1, 2, 3};
+    migraphx::parameter_map m;
+    m["a"] = migraphx::argument{migraphx::shape{migraphx::shape::float_type, {3}}, a.data()};
+    std::vector<float> result;
+    p.eval(m).back().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    return result;
+}
+
+TEST_CASE(key)
+{
+    auto t = migraphx::make_target("ref");
+    auto p = create_program();
+    auto k = migraphx::program_cache_key(p, t);
+    EXPECT(k == migraphx::program_cache_key(create_program(), t));
+    EXPECT(k != migraphx::program_cache_key(create_program(2.0f), t));
+    migraphx::compile_options options;
+    options.offload_copy = true;
+    EXPECT(k != migraphx::program_cache_key(p, t, options));
+}
+
+TEST_CASE(key_env)
+{
+    auto t = migraphx::make_target("ref");
+    auto p = create_program();
+    auto k = migraphx::program_cache_key(p, t);
+    setenv("MIGRAPHX_DISABLE_POINTWISE_FUSION", "1", 1); // NOLINT
+    auto k_fusion = migraphx::program_cache_key(p, t);
+    setenv("MIGRAPHX_TRACE_COMPILE", "1", 1); // NOLINT
+    auto k_trace = migraphx::program_cache_key(p, t);
+    unsetenv("MIGRAPHX_DISABLE_POINTWISE_FUSION"); // NOLINT
+    unsetenv("MIGRAPHX_TRACE_COMPILE");            // NOLINT
+    EXPECT(k != k_fusion);
+    EXPECT(k_fusion == k_trace);
+    EXPECT(k == migraphx::program_cache_key(p, t));
+}
+
+TEST_CASE(put_get)
+{
+    migraphx::tmp_dir td{};
+    migraphx::program_cache cache{{td.path}};
+    auto t   = migraphx::make_target("ref");
+    auto p   = create_program();
+    auto key = migraphx::program_cache_key(p, t);
+    EXPECT(not cache.get(key));
+    p.compile(t);
+    cache.put(key, p);
+    auto cached = cache.get(key);
+    EXPECT(bool{cached});
+    EXPECT(cached->is_compiled());
+    EXPECT(run(*cached) == std::vector<float>{2, 3, 4});
+    EXPECT(not cache.get(migraphx::program_cache_key(create_program(2.0f), t)));
+}
+
+TEST_CASE(get_aligned_literals)
+{
+    migraphx::tmp_dir td{};
+    migraphx::program_cache cache{{td.path}};
+    auto p = create_program();
+    p.compile(migraphx::make_target("ref"));
+    // Keys of several lengths, so the program starts at different offsets
+    std::vector<std::string> keys = {"k", "key", std::string(100, 'k')};
+    for(const auto& key : keys)
+    {
+        cache.put(key, p);
+        auto cached = cache.get(key);
+        EXPECT(bool{cached});
+        auto* mm = cached->get_main_module();
+        auto lit = std::find_if(
+            mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "@literal"; });
+        EXPECT(std::distance(lit, mm->end()) > 0);
+        auto addr = reinterpret_cast<std::uintptr_t>(lit->get_literal().data());
+        EXPECT(addr % 64 == 0);
+        EXPECT(run(*cached) == std::vector<float>{2, 3, 4});
+    }
+}
+
+TEST_CASE(disabled)
+{
+    migraphx::program_cache cache{};
+    EXPECT(not cache.enabled());
+    auto p = create_program();
+    cache.put("key", p);
+    EXPECT(not cache.get("key"));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,62 @@
+#####################################################################################
+# The MIT License (MIT)
+#
+# Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#####################################################################################
+import os, sys
+# A single pool thread runs every feed of the batch
+os.environ["MIGRAPHX_NUM_THREADS"] = "1"
+import migraphx
+try:
+    import numpy as np
+except:
+    sys.exit()
+
+
+def create_program():
+    p = migraphx.program()
+    mm = p.get_main_module()
+    x = mm.add_parameter("x", migraphx.shape(type="float", lens=[4, 8]))
+    y = mm.add_literal(np.arange(32, dtype='float32').reshape(4, 8))
+    add = mm.add_instruction(migraphx.op("add"), [x, y])
+    relu = mm.add_instruction(migraphx.op("relu"), [add])
+    mul = mm.add_instruction(migraphx.op("mul"), [relu, x])
+    mm.add_return([mul])
+    p.compile(migraphx.get_target("cpu"))
+    return p
+
+
+def test_run_batch():
+    p = create_program()
+    feeds = [{
+        "x": (i - 4) * np.ones((4, 8), dtype='float32')
+    } for i in range(8)]
+    # The batch is the first run of the program, so it runs in the memory of
+    # the program
+    futures = p.run_batch(feeds)
+    results = [f.result()[-1].tolist() for f in futures]
+    for feed, result in zip(feeds, results):
+        expected = p.run(feed)[-1].tolist()
+        assert result == expected
+
+
+if __name__ == "__main__":
+    test_run_batch()
@@ -41,5 +41,49 @@ def test_add_op():
     assert output == list(3 * np.ones((9), dtype='float32'))
 
 
+def create_add_program():
+    p = migraphx.program()
+    mm = p.get_main_module()
+    x = mm.add_parameter("x", migraphx.shape(type="float", lens=[3, 3]))
+    y = mm.add_literal(2 * np.ones((3, 3), dtype='float32'))
+    add_op = mm.add_instruction(migraphx.op("add"), [x, y])
+    mm.add_return([add_op])
+    p.compile(migraphx.get_target("ref"))
+    return p
+
+
+def test_run_outputs():
+    p = create_add_program()
+    x = np.ones((3, 3), dtype='float32')
+    out = np.zeros((3, 3), dtype='float32')
+    result = p.run({"x": x}, outputs=[out])
+    assert result[0] is out
+    assert np.array_equal(out, 3 * np.ones((3, 3), dtype='float32'))
+
+
+def test_run_batch():
+    p = create_add_program()
+    feeds = [{"x": i * np.ones((3, 3), dtype='float32')} for i in range(8)]
+    futures = p.run_batch(feeds)
+    for i, f in enumerate(futures):
+        output = f.result()[-1].tolist()
+        assert f.done()
+        assert output == list((i + 2) * np.ones((9), dtype='float32'))
+
+
+def test_run_batch_release_program():
+    p = create_add_program()
+    feeds = [{"x": i * np.ones((3, 3), dtype='float32')} for i in range(8)]
+    futures = p.run_batch(feeds)
+    # The futures keep the program alive until the batch has finished
+    del p
+    for i, f in enumerate(futures):
+        output = f.result()[-1].tolist()
+        assert output == list((i + 2) * np.ones((9), dtype='float32'))
+
+
 if __name__ == "__main__":
     test_add_op()
+    test_run_outputs()
+    test_run_batch()
+    test_run_batch_release_program()
@@ -1129,6 +1129,174 @@ TEST_CASE(int8_quantization_conv)
     }
 }
 
+TEST_CASE(int8_quantization_calibration_per_channel)
+{
+    auto create_program = [](const std::string& name) {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        migraphx::shape sx{migraphx::shape::float_type, {2, 3, 6, 6}};
+        migraphx::shape sw{migraphx::shape::float_type, {4, 3, 3, 3}};
+        migraphx::shape sb{migraphx::shape::float_type, {4, 5}};
+        // Give each output channel of the weights a different range
+        auto w    = migraphx::generate_argument(sw, 1);
+        auto wb   = migraphx::generate_argument(sb, 2);
+        auto data = reinterpret_cast<float*>(w.data());
+        for(std::size_t i = 0; i < sw.elements(); i++)
+            data[i] *= 1 << (i / 27);
+        auto bdata = reinterpret_cast<float*>(wb.data());
+        for(std::size_t i = 0; i < sb.elements(); i++)
+            bdata[i] *= 1 << (i % 5);
+        auto x = mm->add_parameter("x", sx);
+        auto y = mm->add_instruction(migraphx::make_op("convolution"),
+                                     x,
+                                     mm->add_literal(migraphx::literal(sw, w.data())));
+        if(name == "dot")
+        {
+            y = mm->add_instruction(migraphx::make_op("reshape", {{"dims", {32, 4}}}), y);
+            y = mm->add_instruction(
+                migraphx::make_op("dot"), y, mm->add_literal(migraphx::literal(sb, wb.data())));
+        }
+        mm->add_return({y});
+        return p;
+    };
+
+    auto run_prog = [](migraphx::program p, const migraphx::parameter_map& m) {
+        auto t = migraphx::make_target("ref");
+        p.compile(t);
+        std::vector<float> res;
+        p.eval(m).back().visit([&](auto v) { res.assign(v.begin(), v.end()); });
+        return res;
+    };
+
+    migraphx::shape sx{migraphx::shape::float_type, {2, 3, 6, 6}};
+    std::vector<migraphx::parameter_map> cali_data(3);
+    for(std::size_t i = 0; i < cali_data.size(); i++)
+        cali_data[i]["x"] = migraphx::generate_argument(sx, i + 3);
+
+    for(auto calibration : {migraphx::int8_calibration::max,
+                            migraphx::int8_calibration::percentile,
+                            migraphx::int8_calibration::entropy})
+    {
+        for(const std::string name : {"convolution", "dot"})
+        {
+            auto p = create_program(name);
+            migraphx::quantize_int8_options options;
+            options.calibration         = calibration;
+            options.per_channel_weights = true;
+            auto qp                     = p;
+            migraphx::quantize_int8(qp, migraphx::make_target("ref"), cali_data, options);
+
+            auto* mm = qp.get_main_module();
+            EXPECT(std::any_of(mm->begin(), mm->end(), [&](const auto& ins) {
+                return ins.name() == "quant_" + name;
+            }));
+            EXPECT(std::any_of(
+                mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "broadcast"; }));
+
+            auto quant_result    = run_prog(qp, cali_data.front());
+            auto no_quant_result = run_prog(p, cali_data.front());
+            EXPECT(migraphx::verify_range(quant_result, no_quant_result, 300000));
+        }
+    }
+}
+
+// Values in [-1, 1], more of them near 0, in two batches with a single outlier
+static std::vector<migraphx::argument> create_outlier_batches()
+{
+    migraphx::shape s{migraphx::shape::float_type, {5000}};
+    std::vector<migraphx::argument> batches;
+    for(int b = 0; b < 2; b++)
+    {
+        std::vector<float> data(s.elements());
+        for(std::size_t i = 0; i < data.size(); i++)
+        {
+            float t = (b + 2.0f * i) / (2 * data.size());
+            data[i] = (i % 2 == 0 ? t : -t) * t;
+        }
+        if(b == 1)
+            data[42] = 100.0f;
+        batches.push_back(migraphx::literal{s, data}.get_argument());
+    }
+    return batches;
+}
+
+TEST_CASE(int8_calibration_outlier)
+{
+    auto batches = create_outlier_batches();
+    migraphx::quantize_int8_options options;
+    options.calibration = migraphx::int8_calibration::max;
+    auto max_threshold  = migraphx::int8_calibration_threshold(batches, options);
+    EXPECT(migraphx::float_equal(max_threshold, 100.0));
+
+    // The outlier is one value in 10000, so the percentile leaves it out
+    options.calibration       = migraphx::int8_calibration::percentile;
+    auto percentile_threshold = migraphx::int8_calibration_threshold(batches, options);
+    EXPECT(percentile_threshold >= 0.99);
+    EXPECT(percentile_threshold < 1.1);
+
+    // Clipping the outlier loses less information than spreading the int8
+    // levels up to it
+    options.calibration    = migraphx::int8_calibration::entropy;
+    auto entropy_threshold = migraphx::int8_calibration_threshold(batches, options);
+    EXPECT(entropy_threshold >= 0.99);
+    EXPECT(entropy_threshold < max_threshold / 2);
+}
+
+TEST_CASE(int8_calibration_no_outlier)
+{
+    // Without outliers, every calibration keeps the whole range
+    auto batches = create_outlier_batches();
+    batches.pop_back();
+    for(auto calibration : {migraphx::int8_calibration::max,
+                            migraphx::int8_calibration::percentile,
+                            migraphx::int8_calibration::entropy})
+    {
+        migraphx::quantize_int8_options options;
+        options.calibration = calibration;
+        auto threshold      = migraphx::int8_calibration_threshold(batches, options);
+        EXPECT(threshold >= 0.99);
+        EXPECT(threshold < 1.1);
+    }
+}
+
+TEST_CASE(int8_per_channel_scales)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape sx{migraphx::shape::float_type, {2, 3, 6, 6}};
+    migraphx::shape sw{migraphx::shape::float_type, {4, 3, 3, 3}};
+    // Output channel c of the weights has values up to c + 1
+    std::vector<float> w(sw.elements());
+    for(std::size_t i = 0; i < w.size(); i++)
+        w[i] = (i / 27 + 1) * ((i % 27) / 26.0f);
+    auto x = mm->add_parameter("x", sx);
+    mm->add_instruction(
+        migraphx::make_op("convolution"), x, mm->add_literal(migraphx::literal{sw, w}));
+
+    std::size_t param_index = 0;
+    migraphx::run_passes(
+        p, {migraphx::capture_arguments_pass{{"convolution"}, {}, &param_index}});
+    std::vector<std::pair<float, float>> quant_params(param_index, {127.0f, 0.0f});
+    migraphx::run_passes(p,
+                         {migraphx::quantize_int8_pass{{"convolution"}, quant_params, true},
+                          migraphx::dead_code_elimination{}});
+
+    // The weights are quantized with a scale for each output channel
+    auto broadcast = std::find_if(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "broadcast"; });
+    EXPECT(std::distance(broadcast, mm->end()) > 0);
+    std::vector<float> scales;
+    broadcast->inputs().front()->get_literal().visit(
+        [&](auto v) { scales.assign(v.begin(), v.end()); });
+    EXPECT(scales.size() == 4);
+    for(std::size_t c = 0; c < scales.size(); c++)
+        EXPECT(migraphx::float_equal(scales[c], (c + 1) / 127.0f));
+    // The input is quantized with a single scale from the calibration
+    EXPECT(std::count_if(mm->begin(), mm->end(), [](const auto& ins) {
+               return ins.name() == "quantizelinear";
+           }) == 2);
+}
+
 TEST_CASE(int8_subgraph)
 {
     auto create_program = [] {
@@ -1756,4 +1756,40 @@ TEST_CASE(quant_dot_3args_batch)
     }
 }
 
+TEST_CASE(quant_dot_broadcast_batch_large)
+{
+    // Large enough to be split into several tiles, with a broadcasted batch
+    std::size_t m = 37;
+    std::size_t n = 150;
+    std::size_t k = 140;
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape a_shape{migraphx::shape::int8_type, {3, m, k}};
+    migraphx::shape b_shape{migraphx::shape::int8_type, {k, n}};
+    std::vector<int8_t> a(a_shape.elements());
+    std::vector<int8_t> b(b_shape.elements());
+    for(std::size_t i = 0; i < a.size(); i++)
+        a[i] = static_cast<int8_t>(i % 7) - 3;
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = static_cast<int8_t>(i % 5) - 2;
+    auto la = mm->add_literal(migraphx::literal{a_shape, a});
+    auto lb = mm->add_literal(migraphx::literal{b_shape, b});
+    auto bb = mm->add_instruction(
+        migraphx::make_op("multibroadcast", {{"out_lens", {3, k, n}}}), lb);
+    mm->add_instruction(migraphx::make_op("quant_dot"), la, bb);
+
+    std::vector<int> gold(3 * m * n);
+    for(std::size_t batch = 0; batch < 3; batch++)
+        for(std::size_t i = 0; i < m; i++)
+            for(std::size_t j = 0; j < n; j++)
+                for(std::size_t kk = 0; kk < k; kk++)
+                    gold[(batch * m + i) * n + j] += a[(batch * m + i) * k + kk] * b[kk * n + j];
+
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<int> r;
+    result.visit([&](auto output) { r.assign(output.begin(), output.end()); });
+    EXPECT(r == gold);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
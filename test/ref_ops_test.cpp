@@ -1749,6 +1749,105 @@ TEST_CASE(conv2d_test)
     EXPECT(migraphx::verify_range(results_vector, s));
 }
 
+static std::vector<float> naive_conv2d(const std::vector<float>& x,
+                                       const std::vector<std::size_t>& x_lens,
+                                       const std::vector<float>& w,
+                                       const std::vector<std::size_t>& w_lens,
+                                       std::size_t pad,
+                                       std::size_t stride,
+                                       std::size_t dilation,
+                                       std::size_t group)
+{
+    auto oh = (x_lens[2] + 2 * pad - dilation * (w_lens[2] - 1) - 1) / stride + 1;
+    auto ow = (x_lens[3] + 2 * pad - dilation * (w_lens[3] - 1) - 1) / stride + 1;
+    auto kg = w_lens[0] / group;
+    std::vector<float> result(x_lens[0] * w_lens[0] * oh * ow);
+    migraphx::shape_for_each(
+        migraphx::shape{migraphx::shape::float_type, {x_lens[0], w_lens[0], oh, ow}},
+        [&](const auto& o) {
+            double acc = 0;
+            for(std::size_t c = 0; c < w_lens[1]; c++)
+            {
+                auto ic = (o[1] / kg) * w_lens[1] + c;
+                for(std::size_t i = 0; i < w_lens[2]; i++)
+                {
+                    for(std::size_t j = 0; j < w_lens[3]; j++)
+                    {
+                        auto y = std::ptrdiff_t(o[2] * stride + i * dilation) - std::ptrdiff_t(pad);
+                        auto z = std::ptrdiff_t(o[3] * stride + j * dilation) - std::ptrdiff_t(pad);
+                        if(y < 0 or z < 0 or y >= std::ptrdiff_t(x_lens[2]) or
+                           z >= std::ptrdiff_t(x_lens[3]))
+                            continue;
+                        acc += x[((o[0] * x_lens[1] + ic) * x_lens[2] + y) * x_lens[3] + z] *
+                               w[((o[1] * w_lens[1] + c) * w_lens[2] + i) * w_lens[3] + j];
+                    }
+                }
+            }
+            result[((o[0] * w_lens[0] + o[1]) * oh + o[2]) * ow + o[3]] = acc;
+        });
+    return result;
+}
+
+TEST_CASE(conv_algorithms_test)
+{
+    // Shapes that select the winograd, depthwise and dilated im2col paths
+    auto run = [](std::vector<std::size_t> x_lens,
+                  std::vector<std::size_t> w_lens,
+                  std::size_t pad,
+                  std::size_t stride,
+                  std::size_t dilation,
+                  std::size_t group) {
+        migraphx::shape x_shape{migraphx::shape::float_type, x_lens};
+        migraphx::shape w_shape{migraphx::shape::float_type, w_lens};
+        std::vector<float> x(x_shape.elements());
+        std::vector<float> w(w_shape.elements());
+        std::mt19937 gen{0};
+        std::uniform_real_distribution<float> dis{-1.0, 1.0};
+        std::generate(x.begin(), x.end(), [&] { return dis(gen); });
+        std::generate(w.begin(), w.end(), [&] { return dis(gen); });
+
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto xl  = mm->add_literal(migraphx::literal{x_shape, x});
+        auto wl  = mm->add_literal(migraphx::literal{w_shape, w});
+        mm->add_instruction(migraphx::make_op("convolution",
+                                              {{"padding", {pad, pad}},
+                                               {"stride", {stride, stride}},
+                                               {"dilation", {dilation, dilation}},
+                                               {"group", group}}),
+                            xl,
+                            wl);
+        p.compile(migraphx::make_target("ref"));
+        auto result = p.eval({}).back();
+        std::vector<float> results_vector;
+        result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+        return migraphx::verify_range(
+            results_vector, naive_conv2d(x, x_lens, w, w_lens, pad, stride, dilation, group));
+    };
+    EXPECT(run({2, 16, 7, 9}, {24, 16, 3, 3}, 1, 1, 1, 1));
+    EXPECT(run({2, 8, 7, 9}, {8, 1, 3, 3}, 1, 2, 1, 8));
+    EXPECT(run({1, 4, 9, 9}, {6, 2, 3, 3}, 2, 1, 2, 2));
+}
+
+TEST_CASE(conv_1x1_end_padding_test)
+{
+    // A 1x1 kernel with only end padding must not take the path that skips
+    // the unfold, since the padded output positions read no input
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_literal(
+        migraphx::literal{{migraphx::shape::float_type, {1, 1, 2, 2}}, {1, 2, 3, 4}});
+    auto w = mm->add_literal(migraphx::literal{{migraphx::shape::float_type, {1, 1, 1, 1}}, {2}});
+    mm->add_instruction(migraphx::make_op("convolution", {{"padding", {0, 0, 1, 1}}}), x, w);
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    EXPECT(result.get_shape().lens() == std::vector<std::size_t>{1, 1, 3, 3});
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold = {2, 4, 0, 6, 8, 0, 0, 0, 0};
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(conv3d_test)
 {
     migraphx::program p;
@@ -5214,6 +5313,137 @@ TEST_CASE(nms_transpose2_test)
     EXPECT(migraphx::verify_range(result, gold));
 }
 
+static std::vector<int64_t> run_nms(const migraphx::shape& boxes_s,
+                                    const std::vector<float>& boxes_vec,
+                                    const migraphx::shape& scores_s,
+                                    const std::vector<float>& scores_vec,
+                                    int64_t max_out,
+                                    bool center_point_box,
+                                    float min_score = 0.0f)
+{
+    migraphx::program p;
+    auto* mm             = p.get_main_module();
+    auto boxes_l         = mm->add_literal(migraphx::literal(boxes_s, boxes_vec));
+    auto scores_l        = mm->add_literal(migraphx::literal(scores_s, scores_vec));
+    auto max_out_l       = mm->add_literal(max_out);
+    auto iou_threshold   = mm->add_literal(0.5f);
+    auto score_threshold = mm->add_literal(min_score);
+
+    auto r = mm->add_instruction(
+        migraphx::make_op("nonmaxsuppression",
+                          {{"center_point_box", center_point_box}, {"use_dyn_output", true}}),
+        boxes_l,
+        scores_l,
+        max_out_l,
+        iou_threshold,
+        score_threshold);
+    mm->add_return({r});
+
+    p.compile(migraphx::make_target("ref"));
+    auto output = p.eval({}).back();
+    std::vector<int64_t> result;
+    output.visit([&](auto out) { result.assign(out.begin(), out.end()); });
+    return result;
+}
+
+TEST_CASE(nms_score_ties_test)
+{
+    // Boxes 0 and 1, and boxes 3 and 4, overlap with the same score, so the
+    // one that is kept depends on the order of the ties
+    migraphx::shape boxes_s{migraphx::shape::float_type, {1, 6, 4}};
+    std::vector<float> boxes_vec = {0.0, 0.0,  1.0, 1.0,  0.0, 0.1,  1.0, 1.1,
+                                    0.0, 5.0,  1.0, 6.0,  0.0, 10.0, 1.0, 11.0,
+                                    0.0, 10.1, 1.0, 11.1, 0.0, 20.0, 1.0, 21.0};
+
+    migraphx::shape scores_s{migraphx::shape::float_type, {1, 1, 6}};
+    std::vector<float> scores_vec = {0.9, 0.9, 0.8, 0.8, 0.8, 0.5};
+
+    auto result = run_nms(boxes_s, boxes_vec, scores_s, scores_vec, 6, false);
+    std::vector<int64_t> gold = {0, 0, 1, 0, 0, 4, 0, 0, 2, 0, 0, 5};
+    EXPECT(migraphx::verify_range(result, gold));
+}
+
+TEST_CASE(nms_many_boxes_test)
+{
+    // A grid of boxes that each overlap their neighbours, so the boxes that
+    // are kept depend on the order they are suppressed in
+    migraphx::shape boxes_s{migraphx::shape::float_type, {1, 64, 4}};
+    migraphx::shape scores_s{migraphx::shape::float_type, {1, 1, 64}};
+    std::vector<float> boxes_vec;
+    std::vector<float> scores_vec;
+    for(int i = 0; i < 64; i++)
+    {
+        float x = (i % 8) * 0.3f;
+        float y = (i / 8) * 0.3f;
+        boxes_vec.insert(boxes_vec.end(), {y, x, y + 1.0f, x + 1.0f});
+        scores_vec.push_back(((i * 37) % 64) / 64.0f);
+    }
+
+    auto result = run_nms(boxes_s, boxes_vec, scores_s, scores_vec, 64, false);
+    std::vector<int64_t> gold = {0, 0, 19, 0, 0, 38, 0, 0, 57, 0, 0, 12, 0, 0, 31, 0, 0, 50, 0,
+                                 0, 5,  0, 0, 24, 0, 0, 43, 0, 0, 62, 0, 0, 17, 0, 0, 36, 0, 0,
+                                 55, 0, 0, 10, 0, 0, 29, 0, 0, 48, 0, 0, 3,  0, 0, 22, 0, 0, 41,
+                                 0, 0, 60, 0, 0, 15, 0, 0, 34, 0, 0, 53, 0, 0, 8,  0, 0, 1};
+    EXPECT(migraphx::verify_range(result, gold));
+}
+
+TEST_CASE(nms_batches_classes_test)
+{
+    migraphx::shape boxes_s{migraphx::shape::float_type, {2, 6, 4}};
+    std::vector<float> boxes_vec = {0.5, 0.5,  1.0, 1.0, 0.5, 0.6,  1.0, 1.0, 0.5, 0.4,   1.0, 1.0,
+                                    0.5, 10.5, 1.0, 1.0, 0.5, 10.6, 1.0, 1.0, 0.5, 100.5, 1.0, 1.0,
+                                    0.5, 0.5,  1.0, 1.0, 0.5, 0.6,  1.0, 1.0, 0.5, 0.4,   1.0, 1.0,
+                                    0.5, 10.5, 1.0, 1.0, 0.5, 10.6, 1.0, 1.0, 0.5, 100.5, 1.0, 1.0};
+
+    migraphx::shape scores_s{migraphx::shape::float_type, {2, 3, 6}};
+    // Each class of each batch has its own scores
+    std::vector<float> scores_vec = {0.9, 0.75, 0.6, 0.95, 0.5, 0.3,
+                                     0.1, 0.2,  0.3, 0.4,  0.5, 0.6,
+                                     0.6, 0.6,  0.9, 0.1,  0.7, 0.7,
+                                     0.3, 0.95, 0.9, 0.75, 0.6, 0.15,
+                                     0.5, 0.4,  0.3, 0.2,  0.1, 0.0,
+                                     0.8, 0.8,  0.8, 0.8,  0.8, 0.8};
+
+    auto result = run_nms(boxes_s, boxes_vec, scores_s, scores_vec, 2, true, 0.2f);
+    std::vector<int64_t> gold = {0, 0, 3, 0, 0, 0, 0, 1, 5, 0, 1, 4, 0, 2, 2, 0, 2, 5,
+                                 1, 0, 1, 1, 0, 3, 1, 1, 0, 1, 1, 3, 1, 2, 5, 1, 2, 4};
+    EXPECT(migraphx::verify_range(result, gold));
+}
+
+TEST_CASE(nms_zero_max_boxes_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape boxes_s{migraphx::shape::float_type, {1, 6, 4}};
+    std::vector<float> boxes_vec = {0.5, 0.5,  1.0, 1.0, 0.5, 0.6,  1.0, 1.0, 0.5, 0.4,   1.0, 1.0,
+                                    0.5, 10.5, 1.0, 1.0, 0.5, 10.6, 1.0, 1.0, 0.5, 100.5, 1.0, 1.0};
+
+    migraphx::shape scores_s{migraphx::shape::float_type, {1, 1, 6}};
+    std::vector<float> scores_vec = {0.9, 0.75, 0.6, 0.95, 0.5, 0.3};
+
+    auto boxes_l         = mm->add_literal(migraphx::literal(boxes_s, boxes_vec));
+    auto scores_l        = mm->add_literal(migraphx::literal(scores_s, scores_vec));
+    auto max_out_l       = mm->add_literal(int64_t{0});
+    auto iou_threshold   = mm->add_literal(0.5f);
+    auto score_threshold = mm->add_literal(0.0f);
+
+    auto r =
+        mm->add_instruction(migraphx::make_op("nonmaxsuppression", {{"center_point_box", true}}),
+                            boxes_l,
+                            scores_l,
+                            max_out_l,
+                            iou_threshold,
+                            score_threshold);
+    mm->add_return({r});
+
+    p.compile(migraphx::make_target("ref"));
+    auto output = p.eval({}).back();
+    std::vector<int64_t> result;
+    output.visit([&](auto out) { result.assign(out.begin(), out.end()); });
+    std::vector<int64_t> gold(18, 0);
+    EXPECT(migraphx::verify_range(result, gold));
+}
+
 TEST_CASE(nonzero_test)
 {
     migraphx::program p;
@@ -5399,6 +5629,85 @@ TEST_CASE(pointwise_test)
     EXPECT(migraphx::verify_range(results_vector, gold));
 }
 
+TEST_CASE(pointwise_bypass_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {5000}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), -2500);
+    auto l1  = mm->add_literal(migraphx::literal{s, data});
+    auto l2  = mm->add_literal(migraphx::literal{s, data});
+    auto* pm = p.create_module("main:pointwise0");
+    pm->set_bypass();
+    auto x1   = pm->add_parameter("x0", {migraphx::shape::float_type});
+    auto x2   = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto two  = pm->add_literal(2.0f);
+    auto add  = pm->add_instruction(migraphx::make_op("add"), x1, x2);
+    auto mul  = pm->add_instruction(migraphx::make_op("mul"), add, two);
+    auto relu = pm->add_instruction(migraphx::make_op("relu"), mul);
+    pm->add_return({relu});
+    mm->add_instruction(migraphx::make_op("pointwise"), {l1, l2}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(data.size());
+    std::transform(
+        data.begin(), data.end(), gold.begin(), [](auto x) { return std::max(4 * x, 0.0f); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(pointwise_return_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {5000}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), -2500);
+    auto l1  = mm->add_literal(migraphx::literal{s, data});
+    auto l2  = mm->add_literal(migraphx::literal{s, data});
+    auto* pm = p.create_module("main:pointwise0");
+    pm->set_bypass();
+    auto x1  = pm->add_parameter("x0", {migraphx::shape::float_type});
+    auto x2  = pm->add_parameter("x1", {migraphx::shape::float_type});
+    auto add = pm->add_instruction(migraphx::make_op("add"), x1, x2);
+    pm->add_instruction(migraphx::make_op("mul"), x1, x2);
+    pm->add_return({add});
+    mm->add_instruction(migraphx::make_op("pointwise"), {l1, l2}, {pm});
+    // The program is not compiled, so the instruction after the returned one
+    // is not removed
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(data.size());
+    std::transform(data.begin(), data.end(), gold.begin(), [](auto x) { return 2 * x; });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(pointwise_transpose_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto l1  = mm->add_literal(migraphx::literal{s, {0, 1, 2, 3, 4, 5}});
+    auto l2  = mm->add_literal(migraphx::literal{s, {0, 1, 2, 3, 4, 5}});
+    auto t1  = mm->add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), l1);
+    auto r2  = mm->add_instruction(migraphx::make_op("reshape", {{"dims", {3, 2}}}), l2);
+    auto* pm = p.create_module("main:pointwise0");
+    pm->set_bypass();
+    auto x1 = pm->add_parameter("x0", {migraphx::shape::float_type});
+    auto x2 = pm->add_parameter("x1", {migraphx::shape::float_type});
+    pm->add_return({pm->add_instruction(migraphx::make_op("sub"), x1, x2)});
+    mm->add_instruction(migraphx::make_op("pointwise"), {t1, r2}, {pm});
+    p.compile(migraphx::make_target("ref"));
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold = {0, 2, -1, 1, -2, 0};
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(pow_test)
 {
     migraphx::program p;
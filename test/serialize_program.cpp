@@ -22,11 +22,17 @@
  * THE SOFTWARE.
  */
 #include <migraphx/program.hpp>
+#include <migraphx/instruction.hpp>
 #include <migraphx/register_target.hpp>
 #include <migraphx/load_save.hpp>
+#include <migraphx/msgpack.hpp>
+#include <migraphx/generate.hpp>
 #include "test.hpp"
 #include <migraphx/make_op.hpp>
+#include <migraphx/register_op.hpp>
 
+#include <migraphx/file_buffer.hpp>
+#include <algorithm>
 #include <cstdio>
 
 migraphx::program create_program()
@@ -79,6 +85,124 @@ TEST_CASE(as_file)
     EXPECT(p1.sort() == p2.sort());
 }
 
+migraphx::program create_program_with_literals()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+
+    migraphx::shape s{migraphx::shape::float_type, {4, 3, 5}};
+    auto x = mm->add_parameter("x", s);
+    auto a = mm->add_literal(migraphx::generate_literal(s, 1));
+    auto b = mm->add_literal(migraphx::literal{{migraphx::shape::int8_type, {3}}, {1, 2, 3}});
+    auto c = mm->add_literal(migraphx::generate_literal(s, 2));
+    auto add = mm->add_instruction(migraphx::make_op("add"), x, a);
+    auto mul = mm->add_instruction(migraphx::make_op("mul"), add, c);
+    mm->add_return({mul, b});
+    return p;
+}
+
+TEST_CASE(as_file_literals)
+{
+    std::string filename = "migraphx_program_literals.mxr";
+    migraphx::program p1 = create_program_with_literals();
+    migraphx::save(p1, filename);
+    migraphx::program p2 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    auto* mm = p2.get_main_module();
+    EXPECT(std::all_of(mm->begin(), mm->end(), [](const auto& ins) {
+        if(ins.name() != "@literal")
+            return true;
+        // Literal data is aligned in the file
+        return reinterpret_cast<std::uintptr_t>(ins.get_literal().data()) % 64 == 0;
+    }));
+}
+
+// Holds its data the way targets hold literals written to their memory
+struct data_op : migraphx::auto_register_op<data_op>
+{
+    migraphx::argument data;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.data, "data"));
+    }
+
+    std::string name() const { return "data_op"; }
+    migraphx::shape compute_shape(const std::vector<migraphx::shape>&) const
+    {
+        return data.get_shape();
+    }
+    migraphx::argument compute(const migraphx::shape&, const std::vector<migraphx::argument>&) const
+    {
+        return data;
+    }
+};
+
+TEST_CASE(as_file_operator_data)
+{
+    std::string filename = "migraphx_program_operator_data.mxr";
+    migraphx::shape s{migraphx::shape::float_type, {4, 3, 5}};
+    migraphx::program p1;
+    auto* mm1 = p1.get_main_module();
+    data_op op;
+    op.data = migraphx::generate_argument(s, 1);
+    mm1->add_instruction(op);
+    migraphx::save(p1, filename);
+    migraphx::program p2 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p2.sort());
+    auto* mm2 = p2.get_main_module();
+    auto data = migraphx::any_cast<data_op>(std::prev(mm2->end())->get_operator()).data;
+    // The data is used in place from the file, where it is aligned
+    EXPECT(reinterpret_cast<std::uintptr_t>(data.data()) % 64 == 0);
+    EXPECT(data == migraphx::generate_argument(s, 1));
+}
+
+TEST_CASE(as_buffer_operator_data)
+{
+    migraphx::shape s{migraphx::shape::float_type, {4, 3, 5}};
+    migraphx::program p1;
+    auto* mm1 = p1.get_main_module();
+    data_op op;
+    op.data = migraphx::generate_argument(s, 1);
+    mm1->add_instruction(op);
+    std::vector<char> buffer = migraphx::save_buffer(p1);
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(as_buffer_literals)
+{
+    migraphx::program p1     = create_program_with_literals();
+    std::vector<char> buffer = migraphx::save_buffer(p1);
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+}
+
+TEST_CASE(as_msgpack_value)
+{
+    // Programs stored as plain msgpack can still be loaded
+    migraphx::program p1     = create_program_with_literals();
+    std::vector<char> buffer = migraphx::to_msgpack(p1.to_value());
+    migraphx::program p2     = migraphx::load_buffer(buffer);
+    EXPECT(p1.sort() == p2.sort());
+
+    std::string filename = "migraphx_program_msgpack.mxr";
+    migraphx::write_buffer(filename, buffer);
+    migraphx::program p3 = migraphx::load(filename);
+    std::remove(filename.c_str());
+    EXPECT(p1.sort() == p3.sort());
+}
+
+TEST_CASE(truncated_buffer)
+{
+    std::vector<char> buffer = migraphx::save_buffer(create_program_with_literals());
+    buffer.resize(buffer.size() - 1);
+    EXPECT(test::throws([&] { migraphx::load_buffer(buffer); }));
+}
+
 TEST_CASE(compiled)
 {
     migraphx::program p1 = create_program();
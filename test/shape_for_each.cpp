@@ -0,0 +1,127 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/ranges.hpp>
+#include "test.hpp"
+
+migraphx::shape make_shape(std::vector<std::size_t> lens)
+{
+    return {migraphx::shape::float_type, std::move(lens)};
+}
+
+migraphx::shape make_shape(std::vector<std::size_t> lens, std::vector<std::size_t> strides)
+{
+    return {migraphx::shape::float_type, std::move(lens), std::move(strides)};
+}
+
+std::vector<std::vector<std::size_t>> all_indices(const migraphx::shape& s)
+{
+    std::vector<std::vector<std::size_t>> result;
+    migraphx::shape_for_each(s, [&](const auto& idx) { result.push_back(idx); });
+    return result;
+}
+
+template <class... Shapes>
+bool verify_offsets(const migraphx::shape& s, const Shapes&... ss)
+{
+    migraphx::shape ss0{s.type(), s.lens()};
+    std::vector<std::vector<std::size_t>> expected;
+    std::transform(migraphx::range(s.elements()).begin(),
+                   migraphx::range(s.elements()).end(),
+                   std::back_inserter(expected),
+                   [&](auto i) {
+                       auto idx = ss0.multi(i);
+                       return std::vector<std::size_t>{s.index(idx), ss.index(idx)...};
+                   });
+    std::vector<std::vector<std::size_t>> result;
+    migraphx::shape_for_each_offset(s, ss...)(
+        [&](auto... is) { result.push_back(std::vector<std::size_t>{is...}); });
+    return result == expected;
+}
+
+TEST_CASE(for_each_order)
+{
+    auto s   = make_shape({2, 3, 4});
+    auto ids = all_indices(s);
+    EXPECT(ids.size() == s.elements());
+    for(std::size_t i = 0; i < ids.size(); i++)
+        EXPECT(ids[i] == s.multi(i));
+}
+
+TEST_CASE(for_each_scalar)
+{
+    migraphx::shape s{migraphx::shape::float_type, {1}, {0}};
+    auto ids = all_indices(s);
+    EXPECT(ids.size() == s.elements());
+    EXPECT(ids.front() == std::vector<std::size_t>{0});
+}
+
+TEST_CASE(for_each_empty)
+{
+    auto s = make_shape({2, 0, 3});
+    EXPECT(all_indices(s).empty());
+    std::size_t n = 0;
+    migraphx::shape_for_each_offset(s, s)([&](auto, auto) { n++; });
+    EXPECT(n == 0);
+}
+
+TEST_CASE(offset_standard)
+{
+    auto s = make_shape({2, 3, 4, 5});
+    EXPECT(verify_offsets(s));
+    EXPECT(verify_offsets(s, s));
+}
+
+TEST_CASE(offset_transposed)
+{
+    auto s1 = make_shape({2, 3, 4, 5});
+    auto s2 = make_shape({2, 3, 4, 5}, {60, 1, 15, 3});
+    EXPECT(verify_offsets(s1, s2));
+    EXPECT(verify_offsets(s2, s1));
+}
+
+TEST_CASE(offset_broadcast)
+{
+    auto s1 = make_shape({2, 3, 4, 5});
+    auto s2 = make_shape({2, 3, 4, 5}, {0, 1, 0, 0});
+    auto s3 = make_shape({2, 3, 4, 5}, {20, 0, 5, 1});
+    EXPECT(verify_offsets(s1, s2, s3));
+}
+
+TEST_CASE(offset_sliced)
+{
+    auto s1 = make_shape({2, 3, 4});
+    auto s2 = make_shape({2, 3, 4}, {40, 8, 2});
+    EXPECT(verify_offsets(s1, s2));
+}
+
+TEST_CASE(offset_single_dim)
+{
+    auto s1 = make_shape({7});
+    auto s2 = make_shape({7}, {3});
+    EXPECT(verify_offsets(s1, s2));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/thread_pool.hpp>
+#include <migraphx/par_for.hpp>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <test.hpp>
+#include <sched.h>
+
+TEST_CASE(parallel_all)
+{
+    migraphx::thread_pool pool{4};
+    EXPECT(pool.size() == 4);
+    std::vector<std::size_t> result(100);
+    pool.parallel(result.size(), [&](std::size_t i) { result[i] = i; });
+    std::vector<std::size_t> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT(result == expected);
+}
+
+TEST_CASE(parallel_nested)
+{
+    migraphx::thread_pool pool{4};
+    std::atomic<std::size_t> count{0};
+    pool.parallel(8, [&](std::size_t) { pool.parallel(8, [&](std::size_t) { count++; }); });
+    EXPECT(count.load() == 64);
+}
+
+TEST_CASE(parallel_concurrent)
+{
+    migraphx::thread_pool pool{2};
+    std::atomic<std::size_t> count{0};
+    std::vector<std::thread> threads;
+    for(std::size_t i = 0; i < 4; i++)
+        threads.emplace_back([&] { pool.parallel(16, [&](std::size_t) { count++; }); });
+    for(auto& t : threads)
+        t.join();
+    EXPECT(count.load() == 64);
+}
+
+TEST_CASE(parallel_throws)
+{
+    migraphx::thread_pool pool{4};
+    std::atomic<std::size_t> count{0};
+    EXPECT(test::throws([&] {
+        pool.parallel(8, [&](std::size_t i) {
+            count++;
+            if(i == 3)
+                throw std::runtime_error("error");
+        });
+    }));
+    EXPECT(count.load() == 8);
+}
+
+static cpu_set_t thread_affinity()
+{
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    EXPECT(sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0);
+    return cpuset;
+}
+
+TEST_CASE(parallel_affinity)
+{
+    auto process      = thread_affinity();
+    std::size_t ncpus = CPU_COUNT(&process);
+    // A pool larger than the cpus of the process is not pinned at all
+    for(std::size_t nthreads : {std::size_t{2}, ncpus, ncpus + 2})
+    {
+        migraphx::thread_pool pool{nthreads, true};
+        std::atomic<std::size_t> outside{0};
+        std::atomic<std::size_t> pinned{0};
+        pool.parallel(64, [&](std::size_t) {
+            auto cpuset = thread_affinity();
+            cpu_set_t both;
+            CPU_AND(&both, &cpuset, &process);
+            if(not CPU_EQUAL(&both, &cpuset))
+                outside++;
+            if(CPU_COUNT(&cpuset) == 1 and ncpus > 1)
+                pinned++;
+        });
+        EXPECT(outside.load() == 0);
+        if(nthreads > ncpus)
+            EXPECT(pinned.load() == 0);
+    }
+}
+
+TEST_CASE(par_for_all)
+{
+    std::vector<int> result(1000);
+    migraphx::par_for(result.size(), 1, [&](std::size_t i) { result[i] = 1; });
+    EXPECT(std::accumulate(result.begin(), result.end(), 0) == 1000);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -46,6 +46,11 @@ struct context
 {
     /// Wait for any tasks in the context to complete
     void finish() const;
+    /// An optional method to make a context to run the program concurrently
+    /// with this one. It shares what is constant after compilation, such as
+    /// the literals, and owns the rest, such as the streams. When it is not
+    /// implemented, it is a copy of the context.
+    context fork() const;
 };
 
 #else
@@ -75,6 +80,11 @@ void wait_for_context(T&, any_ptr)
 template <class T>
 void finish_on_context(T&, any_ptr){}
 
+struct context;
+
+template <class T>
+context fork_context(const T& x);
+
 <%
  interface('context',
            virtual('to_value', returns = 'value', const = True, default = 'to_value_context'),
@@ -82,7 +92,14 @@ void finish_on_context(T&, any_ptr){}
            virtual('get_queue', returns = 'any_ptr', default = 'get_queue_context'),
            virtual('wait_for', queue = 'any_ptr', returns = 'void', default = 'wait_for_context'),
            virtual('finish_on', queue = 'any_ptr', returns = 'void', default = 'finish_on_context'),
-           virtual('finish', returns = 'void', const = True)) %>
+           virtual('finish', returns = 'void', const = True),
+           virtual('fork', returns = 'context', const = True, default = 'fork_context')) %>
+
+template <class T>
+context fork_context(const T& x)
+{
+    return x;
+}
 
     inline void migraphx_to_value(value& v, const context& ctx)
 {
@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_MIGRAPHLIB_OPERAND_HPP
 #define MIGRAPHX_GUARD_MIGRAPHLIB_OPERAND_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 #include <functional>
@@ -82,6 +83,14 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional method to return the number of floating point operations
+    /// done for the input shapes. It is 0 when it is not implemented.
+    std::size_t flops(const std::vector<shape>& input) const;
+    /// An optional method to return the number of bytes read and written for
+    /// the input shapes. When it is not implemented, it is the size of the
+    /// inputs and of the output, except for an input the output aliases, and
+    /// it is 0 for an operation returning a view of its only input.
+    std::size_t bytes(const std::vector<shape>& input) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -405,6 +414,47 @@ std::ptrdiff_t output_alias_op(const T&, const std::vector<shape>&)
     return -1;
 }
 
+template <class T>
+std::size_t flops_op(const T&, const std::vector<shape>&)
+{
+    return 0;
+}
+
+template <class T>
+auto output_alias_of(rank<1>, const T& x, const std::vector<shape>& inputs)
+    -> decltype(x.output_alias(inputs))
+{
+    return x.output_alias(inputs);
+}
+
+template <class T>
+std::ptrdiff_t output_alias_of(rank<0>, const T&, const std::vector<shape>&)
+{
+    return -1;
+}
+
+template <class T>
+std::size_t bytes_op(const T& x, const std::vector<shape>& inputs)
+{
+    if(std::any_of(inputs.begin(), inputs.end(), [](const auto& s) { return s.dynamic(); }))
+        return 0;
+    auto alias = output_alias_of(rank<1>{}, x, inputs);
+    // An operation that aliases its only input returns a view of it
+    if(alias == 0 and inputs.size() == 1)
+        return 0;
+    auto output = compute_shape_op(x, inputs);
+    if(output.dynamic())
+        return 0;
+    std::size_t result = output.bytes();
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        // The aliased input is the buffer the output is written to
+        if(static_cast<std::ptrdiff_t>(i) != alias)
+            result += inputs[i].bytes();
+    }
+    return result;
+}
+
 template <class T>
 auto finalize_op(
     rank<1>, T& x, context& ctx, const shape& output_shape, const std::vector<shape>& input)
@@ -512,6 +562,16 @@ lifetime get_lifetime_op(const T&)
              input   = 'const std::vector<shape>&',
              const   = True,
              default = 'detail::output_alias_op'),
+     virtual('flops',
+             returns = 'std::size_t',
+             input   = 'const std::vector<shape>&',
+             const   = True,
+             default = 'detail::flops_op'),
+     virtual('bytes',
+             returns = 'std::size_t',
+             input   = 'const std::vector<shape>&',
+             const   = True,
+             default = 'detail::bytes_op'),
      virtual('compile',
              returns = 'value',
              ctx     = 'context&',